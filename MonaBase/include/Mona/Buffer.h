@@ -51,23 +51,46 @@ struct Buffer : Binary, virtual Object {
 	static Buffer&   Null() { static Buffer Null(0, nullptr); return Null; } // usefull for Writer Serializer for example (and can't be encapsulate in a shared<Buffer>)
 
 
+	/*!
+	Allocator of buffers, alloc and free are called without lock and have to be thread-safe,
+	each thread keeps a reference on the current allocator refreshed only after a new Set */
 	struct Allocator : virtual Object {
 		template<typename AllocatorType=Allocator, typename ...Args>
-		static void   Set(Args&&... args) { Lock(); _PAllocator.set<AllocatorType>(std::forward<Args>(args)...); Unlock(); }
+		static void   Set(Args&&... args) { Lock(); _PAllocator.set<AllocatorType>(std::forward<Args>(args)...); ++_Generation; Unlock(); }
+		/*!
+		Get the current allocator if it's a AllocatorType, null otherwise */
+		template<typename AllocatorType = Allocator>
+		static shared<AllocatorType> Get() { Lock(); shared<AllocatorType> pAllocator(Mona::dynamic_pointer_cast<AllocatorType>(_PAllocator)); Unlock(); return pAllocator; }
 		static UInt8* Alloc(UInt32& size);
 		static void	  Free(UInt8* buffer, UInt32 size);
 		static UInt32 ComputeCapacity(UInt32 size);
 	protected:
 		virtual UInt8* alloc(UInt32& capacity) { return new UInt8[capacity]; }
 		virtual void   free(UInt8* buffer, UInt32 capacity) { delete[] buffer; }
+		/*!
+		True if this allocator frees itself the buffers of the arena (see SetArena) */
+		virtual bool   arena() const { return false; }
+
+		/*!
+		Memory range [begin, end[ living for the process whose buffers are given to release rather than to free
+		of an allocator without arena() support, for the arena buffers freed after the replacement of their allocator.
+		One arena by process, to set before its first buffer allocation */
+		static void SetArena(const UInt8* begin, const UInt8* end, void(*release)(UInt8* buffer)) { _ArenaBegin = begin; _ArenaEnd = end; _ArenaRelease = release; }
 
 		static void Lock() { while (!TryLock()) std::this_thread::yield(); }
 		static void Unlock() { _Mutex.clear(std::memory_order_release); }
 	private:
 		static bool TryLock() { return !_Mutex.test_and_set(std::memory_order_acquire); }
+		static Allocator* Current();
+		static void Free(Allocator& allocator, UInt8* buffer, UInt32 size);
+
+		static std::atomic_flag		_Mutex;
+		static shared<Allocator>	_PAllocator;
+		static std::atomic<UInt32>	_Generation;
 
-		static std::atomic_flag  _Mutex;
-		static unique<Allocator> _PAllocator;
+		static const UInt8*			_ArenaBegin;
+		static const UInt8*			_ArenaEnd;
+		static void					(*_ArenaRelease)(UInt8* buffer);
 	};
 private:
 	Buffer(UInt32 size, void* buffer);
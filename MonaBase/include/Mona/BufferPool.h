@@ -18,36 +18,109 @@ details (or else see http://mozilla.org/MPL/2.0/).
 
 #include "Mona/Mona.h"
 #include "Mona/Buffer.h"
-#include "Mona/Thread.h"
+#include "Mona/Time.h"
+#include <mutex>
+#include <vector>
 
 namespace Mona {
 
-struct BufferPool : Buffer::Allocator, private Thread, virtual Object {
+/*!
+Pool of buffers by power of two size class, each thread keeps a small magazine of buffers by class
+refilled from and returned to a central depot by batch, so the most part of alloc/free are without lock.
+The depot releases buffers unused during 10 seconds (see manage), and the pool, magazines included, never keeps more than maxMemory (0 = unlimited).
+With hugePages > 0 the classes from 64KB to 2MB are carved from an arena of pre-faulted 2MB huge pages,
+arena is allocated one time for the process life (its buffers can be freed after the BufferPool replacement, see Buffer::Allocator::SetArena) */
+struct BufferPool : Buffer::Allocator, virtual Object {
+	BufferPool(UInt64 maxMemory = 0, UInt32 hugePages = 0);
 
-	BufferPool() : Thread("BufferPool") { start(Thread::PRIORITY_LOWEST); }
-	~BufferPool() { stop(); }
+	/*!
+	Allocations served by the pool for the size class of capacity */
+	UInt64 hits(UInt32 capacity) const { return _pDepot->classes[ComputeIndex(capacity)].hits; }
+	/*!
+	Allocations which has required a system allocation for the size class of capacity */
+	UInt64 misses(UInt32 capacity) const { return _pDepot->classes[ComputeIndex(capacity)].misses; }
+	/*!
+	Memory kept by the pool for the size class of capacity (resident, unused) */
+	UInt64 memory(UInt32 capacity) const { return _pDepot->classes[ComputeIndex(capacity)].memory; }
+	/*!
+	Memory kept by the pool for all size classes */
+	UInt64 memory() const { return _pDepot->memory; }
+	UInt64 maxMemory() const { return _pDepot->maxMemory; }
+
+	/*!
+	Slabs of 2MB of the huge pages arena, 0 if there is no arena */
+	UInt32 arenaSlabs() const;
+	/*!
+	Slabs of the arena carved for size classes (used), an arena full makes fall back on system allocations */
+	UInt32 arenaOccupancy() const;
+	/*!
+	Slabs of the arena carved for the size class of capacity */
+	UInt32 arenaSlabs(UInt32 capacity) const;
+	/*!
+	Buffers of the arena used by the size class of capacity (in use or kept by the pool) */
+	UInt32 arenaBuffers(UInt32 capacity) const;
+	/*!
+	True if the arena is on reserved huge pages (vm.nr_hugepages), false for transparent huge pages */
+	bool   arenaHugeTLB() const;
+
+	/*!
+	Release the buffers of the depot unused during 10 seconds, to call regularly:
+	without it the depot is trimmed just on allocation activity of the size class */
+	void   manage();
 
 private:
-	UInt8* alloc(UInt32& capacity) {
-		UInt8* buffer = _buffers[computeIndex(capacity)].pop();
-		return buffer ? buffer : new UInt8[capacity];
-	}
-	void   free(UInt8* buffer, UInt32 capacity) { _buffers[computeIndex(capacity)].push(buffer); }
-
-	bool run(Exception& ex, const volatile bool& requestStop);
-	UInt8 computeIndex(UInt32 capacity);
-
-	struct Buffers : private std::vector<UInt8*>, virtual Object {
-		Buffers() : _minSize(0), _maxSize(0) {}
-		~Buffers() { for (UInt8* buffer : self) delete[] buffer; }
-		UInt8* pop();
-		void   push(UInt8* buffer);
-		void manage(std::vector<UInt8*>& gc);
-	private:
-		UInt32 _minSize;
-		UInt32 _maxSize;
+	UInt8* alloc(UInt32& capacity);
+	void   free(UInt8* buffer, UInt32 capacity);
+	bool   arena() const { return true; } // magazines keep the arena buffers too, Release returns them
+
+	/*!
+	Release a buffer of a system allocation, returns it to the arena if it comes from */
+	static void   Release(UInt8* buffer);
+
+	static UInt8 ComputeIndex(UInt32 capacity);
+	/*!
+	System allocation, from the arena if possible */
+	static UInt8* Allocate(UInt8 index, UInt32 capacity);
+
+	struct Depot : virtual Object {
+		Depot(UInt64 maxMemory) : maxMemory(maxMemory), memory(0) {}
+
+		struct Class : virtual Object {
+			Class() : hits(0), misses(0), memory(0), _minSize(0) {}
+			~Class();
+			/*!
+			Move until count buffers in buffers (magazine), returns the number moved */
+			UInt8 pop(UInt8** buffers, UInt8 count, UInt32 capacity, Depot& depot);
+			/*!
+			Move count buffers of buffers (magazine), buffers which exceed maxMemory are left to delete */
+			UInt8 push(UInt8** buffers, UInt8 count, UInt32 capacity, Depot& depot);
+			/*!
+			Release buffers unused since 10 seconds, mutex has to be locked */
+			void  manage(UInt32 capacity, Depot& depot);
+
+			std::atomic<UInt64>	hits;
+			std::atomic<UInt64>	misses;
+			std::atomic<UInt64>	memory;
+			std::mutex			mutex;
+		private:
+			std::vector<UInt8*>	_buffers;
+			UInt32				_minSize; // buffers unused since last manage
+			Time				_managed;
+		};
+		/*!
+		Count a buffer kept by a magazine with maxMemory, returns false if it exceeds maxMemory */
+		bool keep(Class& depotClass, UInt32 capacity);
+
+		Class				classes[28];
+		const UInt64		maxMemory;
+		std::atomic<UInt64>	memory;
 	};
-	Buffers			 _buffers[28];
+	struct Magazines;
+	Magazines* magazines();
+
+	struct Arena;
+
+	shared<Depot> _pDepot;
 };
 
 
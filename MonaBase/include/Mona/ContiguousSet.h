@@ -0,0 +1,132 @@
+/*
+This file is a part of MonaSolutions Copyright 2017
+mathieu.poux[a]gmail.com
+jammetthomas[a]gmail.com
+
+This program is free software: you can redistribute it and/or
+modify it under the terms of the the Mozilla Public License v2.0.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+Mozilla Public License v. 2.0 received along this program for more
+details (or else see http://mozilla.org/MPL/2.0/).
+
+*/
+
+#pragma once
+
+#include "Mona/Mona.h"
+#include <vector>
+#include <unordered_map>
+
+namespace Mona {
+
+/*!
+Set of pointers stored contiguously for a cache-friendly iteration (no red-black tree nodes to chase), without order.
+Erasing during an iteration is safe: the element is replaced by a tombstone skipped by iterations, and tombstones are removed
+out of any iteration by compact(), or on emplace/erase when they exceed half of the slots. Adding during an iteration is safe too
+(iterator works by index, and iterates the element added).
+Iteration step is an index compared to the slots count and a raw read of the slot (no vector call), an iterator at the end takes the end() index
+to be compared by a simple index equality. */
+template<typename Type>
+struct ContiguousSet : virtual Object {
+	struct const_iterator {
+		const_iterator(const ContiguousSet& set, UInt32 index) : _set(set), _index(index) {
+			++_set._iterations;
+			while (_index < _set._slots && !_set._data[_index])
+				++_index;
+			if (_index >= _set._slots)
+				_index = END;
+		}
+		const_iterator(const const_iterator& other) : _set(other._set), _index(other._index) { ++_set._iterations; }
+		~const_iterator() { --_set._iterations; }
+		Type*				operator*() const { return _set._data[_index]; }
+		const_iterator&		operator++() {
+			while (++_index < _set._slots && !_set._data[_index]);
+			if (_index >= _set._slots)
+				_index = END;
+			return self;
+		}
+		bool				operator==(const const_iterator& other) const { return _index == other._index; }
+		bool				operator!=(const const_iterator& other) const { return _index != other._index; }
+	private:
+		const ContiguousSet&	_set;
+		UInt32					_index;
+	};
+
+	/*!
+	Iteration in progress by slots (see slot), no compaction while it lives */
+	struct Iteration : virtual Object {
+		Iteration(const ContiguousSet& set) : _set(set) { ++_set._iterations; }
+		~Iteration() { --_set._iterations; }
+	private:
+		const ContiguousSet& _set;
+	};
+
+	ContiguousSet() : _tombstones(0), _data(NULL), _slots(0), _iterations(0) {}
+
+	UInt32			size() const { return _slots - _tombstones; }
+	bool			empty() const { return !size(); }
+	UInt32			count(const Type* pElement) const { return UInt32(_indexes.count(pElement)); }
+
+	const_iterator	begin() const { return const_iterator(self, 0); }
+	const_iterator	end() const { return const_iterator(self, END); } // elements added during the iteration are iterated (end is reached on the last slot)
+
+	/*!
+	Slots access to share the iteration between threads, slot(index) returns NULL on tombstone */
+	UInt32			slots() const { return _slots; }
+	Type*			slot(UInt32 index) const { return _data[index]; }
+
+	bool emplace(Type* pElement) {
+		if (_tombstones > (_slots >> 1))
+			compact(); // churn without compact call, before to index the new one
+		if (!_indexes.emplace(pElement, _slots).second)
+			return false;
+		_elements.emplace_back(pElement);
+		_data = _elements.data();
+		++_slots;
+		return true;
+	}
+	UInt32 erase(const Type* pElement) {
+		const auto& it = _indexes.find(pElement);
+		if (it == _indexes.end())
+			return 0;
+		_elements[it->second] = NULL; // tombstone
+		++_tombstones;
+		_indexes.erase(it);
+		if (_tombstones > (_slots >> 1))
+			compact();
+		return 1;
+	}
+	/*!
+	Remove tombstones, without effect during an iteration (iterator or Iteration alive) */
+	void compact() {
+		if (!_tombstones || _iterations)
+			return;
+		UInt32 size(0);
+		for (Type* pElement : _elements) {
+			if (!pElement)
+				continue;
+			_indexes[pElement] = size;
+			_elements[size++] = pElement;
+		}
+		_elements.resize(size);
+		_slots = size;
+		_tombstones = 0;
+	}
+
+private:
+	enum : UInt32 { END = 0xFFFFFFFF };
+
+	std::vector<Type*>							_elements;
+	std::unordered_map<const Type*, UInt32>		_indexes;
+	UInt32										_tombstones;
+	// raw view of _elements for the iterations
+	Type* const*								_data;
+	UInt32										_slots;
+	mutable UInt32								_iterations;
+};
+
+
+} // namespace Mona
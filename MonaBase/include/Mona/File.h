@@ -19,6 +19,8 @@ details (or else see http://mozilla.org/MPL/2.0/).
 #include "Mona/Mona.h"
 #include "Mona/Path.h"
 #include "Mona/Handler.h"
+#include "Mona/Packet.h"
+#include <deque>
 
 namespace Mona {
 
@@ -68,6 +70,9 @@ struct File : virtual Object {
 	Int64		lastChange(bool refresh = false) const { return _path.lastChange(refresh); }
 
 	bool		loaded() const { return _loaded; }
+	/*!
+	True if writing bypasses the system cache (O_DIRECT), see setDirect */
+	bool		direct() const { return _direct; }
 
 	UInt64		readen() const { return _readen; }
 	UInt64		written() const { return _written; }
@@ -86,6 +91,10 @@ struct File : virtual Object {
 	If writing error => Ex::System::File || Ex::Permission */
 	bool				write(Exception& ex, const void* data, UInt32 size);
 	/*!
+	Gathered writing of packets in one system call (writev)
+	If writing error => Ex::System::File || Ex::Permission */
+	bool				write(Exception& ex, const std::deque<Packet>& packets);
+	/*!
 	If deletion error => Ex::System::File || Ex::Permission
 	/!\ One time deleted no more write operation is possible */
 	bool				erase(Exception& ex);
@@ -95,7 +104,16 @@ struct File : virtual Object {
 
 	void				reset(UInt64 position = 0);
 
+	/*!
+	Write without system cache (O_DIRECT on Linux, ignored on other platforms), usefull for long recordings which are not read back,
+	it must be set before loading, and is disabled on load if the file system doesn't support it (or if APPEND file size is unaligned).
+	Data are written by aligned blocks, the last incomplete block is written on reset, on IOFile::unsubscribe (by the IOFile queue), or else on close */
+	void				setDirect(bool direct) { _direct = direct; }
+
 private:
+	bool				writeDirect(Exception& ex, const UInt8* data, UInt32 size, UInt64 total);
+	bool				endDirect(Exception& ex);
+
 	Path				_path;
 	volatile bool		_loaded;
 	std::atomic<UInt64>	_readen;
@@ -105,6 +123,9 @@ private:
 #else
 	long				_handle;
 #endif
+	std::atomic<bool>	_direct;
+	UInt8*				_pStaging; // aligned block to write in direct mode
+	UInt32				_staged;
 
 	//// Used by IOFile /////////////////////
 	Decoder*					_pDecoder;
@@ -118,7 +139,14 @@ private:
 	UInt16						_ioTrack;
 	UInt16						_decodingTrack;
 	const Handler*				_pHandler; // to diminue size of Action+Handle
+	std::atomic<UInt32>			_pending; // IOFile actions queued
+	std::mutex					_mutexWritings;
+	std::deque<Packet>*			_pWritings; // packets of the WriteFile queued, to write them together
+	std::deque<Packet>			_writings; // packets waiting the end of the io_uring writing in progress
+	std::atomic<bool>			_ringWriting;
+	Signal						_ringWritten;
 	friend struct IOFile;
+	friend struct Socket;
 };
 
 
@@ -33,9 +33,25 @@ struct FileLogger : Logger, virtual Object {
 
 	bool log(LOG_LEVEL level, const Path& file, long line, const std::string& message);
 	bool dump(const std::string& header, const UInt8* data, UInt32 size);
+
+protected:
+	/*!
+	Logger with files [0-rotation].extension in dir */
+	FileLogger(std::string&& dir, UInt32 sizeByFile, UInt16 rotation, const char* extension);
+	/*!
+	Write data in the current file and rotate files if need */
+	bool write(const UInt8* data, UInt32 size);
+	/*!
+	Size written in the current file, 0 on a new file */
+	UInt32 written() const { return _written; }
+	/*!
+	Called when rotation has started a new empty file */
+	virtual void onRotation() {}
+
 private:
 	void manage(UInt32 written);
 
+	const char*		_extension;
 	unique<File>	_pFile;
 	UInt32			_written;
 	UInt16			_rotation;
@@ -29,10 +29,13 @@ struct FileWriter : virtual Object {
 	typedef File::OnError	 ON(Error);
 	NULLABLE(!_pFile)
 	
-	FileWriter(IOFile& io) : io(io) {}
+	FileWriter(IOFile& io) : io(io), direct(false) {}
 	~FileWriter() { close(); }
 
 	IOFile&	io;
+	/*!
+	Write without system cache on next open, see File::setDirect */
+	bool	direct;
 
 	UInt64	queueing() const { return _pFile ? _pFile->queueing() : 0; }
 
@@ -46,7 +49,7 @@ struct FileWriter : virtual Object {
 	/!\ don't open really the file, because performance are better if opened on first write operation */
 	FileWriter& open(const Path& path, bool append = false) {
 		close();
-		_pFile.set(path, append ? File::MODE_APPEND : File::MODE_WRITE);
+		_pFile.set(path, append ? File::MODE_APPEND : File::MODE_WRITE).setDirect(direct);
 		io.subscribe(_pFile, onError, onFlush);
 		return self;
 	}
@@ -20,28 +20,35 @@ details (or else see http://mozilla.org/MPL/2.0/).
 #include "Mona/Runner.h"
 #include "Mona/Event.h"
 #include "Mona/Signal.h"
-#include <deque>
+#include "Mona/MPSCQueue.h"
 
 namespace Mona {
 
 struct Handler : virtual Object {
-	Handler(Signal& signal) : _pSignal(&signal) {}
-	Handler() : _pSignal(NULL) {}
+	Handler(Signal& signal) : _pSignal(&signal), _producers(0) {}
+	Handler() : _pSignal(NULL), _producers(0) {}
 
 	void	 reset(Signal& signal);
 	UInt32	 flush(bool last=false);
 
+	/*!
+	Times where flush has had to wait the end of a queueing */
+	UInt64	 contentions() const { return _runners.contentions(); }
+	/*!
+	Signals sent to wake up the handler thread, queueings on a non-empty queue are coalesced */
+	UInt64	 wakeUps() const { return _runners.wakeUps(); }
+
 	/*!
 	Try to queue a shared RunnerType, returns false if failed */
 	template<typename RunnerType, typename = typename std::enable_if<std::is_constructible<shared<Runner>, RunnerType>::value>::type>
 	bool tryQueue(RunnerType&& pRunner) const {
 		DEBUG_ASSERT(pRunner); // more easy to debug that if it fails in the thread!
-		std::lock_guard<std::mutex> lock(_mutex);
-		if (!_pSignal)
-			return false;
-		_runners.emplace_back(std::forward<RunnerType>(pRunner));
-		_pSignal->set();
-		return true;
+		++_producers; // before to read _pSignal, a last flush waits the end of this queueing
+		Signal* pSignal = _pSignal;
+		if (pSignal && _runners.push(std::forward<RunnerType>(pRunner)))
+			pSignal->set();
+		--_producers;
+		return pSignal ? true : false;
 	}
 	/*!
 	Try to build and queue a RunnerType, returns false if failed */
@@ -93,9 +100,9 @@ struct Handler : virtual Object {
 
 private:
 
-	mutable std::mutex					_mutex;
-	mutable std::deque<shared<Runner>>	_runners;
-	Signal*								_pSignal;
+	mutable MPSCQueue<shared<Runner>>	_runners;
+	std::atomic<Signal*>				_pSignal;
+	mutable std::atomic<UInt32>			_producers; // queueings in progress
 };
 
 
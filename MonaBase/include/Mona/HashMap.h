@@ -0,0 +1,153 @@
+/*
+This file is a part of MonaSolutions Copyright 2017
+mathieu.poux[a]gmail.com
+jammetthomas[a]gmail.com
+
+This program is free software: you can redistribute it and/or
+modify it under the terms of the the Mozilla Public License v2.0.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+Mozilla Public License v. 2.0 received along this program for more
+details (or else see http://mozilla.org/MPL/2.0/).
+
+*/
+
+#pragma once
+
+#include "Mona/Mona.h"
+#include <vector>
+#include <functional>
+
+namespace Mona {
+
+/*!
+Open addressing hash map (linear probing) for hot lookups: entries are stored contiguously with their hash,
+a lookup is a few adjacent slot reads, no node to allocate nor chase. Erase shifts back the following entries (no tombstone),
+so an iterator is invalidated by erase and emplace. Capacity is a power of 2 doubled above 3/4 of load.
+Hasher must spread keys on the low bits (the slot index is the hash masked) */
+template<typename KeyType, typename ValueType, typename Hasher = std::hash<KeyType>, typename Equal = std::equal_to<KeyType>>
+struct HashMap : virtual Object {
+	typedef std::pair<KeyType, ValueType> value_type;
+private:
+	struct Slot {
+		Slot() : hash(0) {}
+		UInt32		hash; // 0 means free
+		value_type	entry;
+	};
+	template<typename SlotsType, typename EntryType>
+	struct Iterator {
+		Iterator(SlotsType& slots, UInt32 index) : _slots(slots), _index(index) { while (_index < _slots.size() && !_slots[_index].hash) ++_index; }
+		EntryType&	operator*() const { return _slots[_index].entry; }
+		EntryType*	operator->() const { return &_slots[_index].entry; }
+		Iterator&	operator++() { while (++_index < _slots.size() && !_slots[_index].hash); return self; }
+		bool		operator==(const Iterator& other) const { return _index == other._index; }
+		bool		operator!=(const Iterator& other) const { return _index != other._index; }
+		UInt32		index() const { return _index; }
+	private:
+		SlotsType&	_slots;
+		UInt32		_index;
+	};
+public:
+	typedef Iterator<std::vector<Slot>, value_type>					iterator;
+	typedef Iterator<const std::vector<Slot>, const value_type>		const_iterator;
+
+	HashMap(UInt32 capacity = 16) : _size(0) { reset(capacity); }
+
+	UInt32			size() const { return _size; }
+	bool			empty() const { return !_size; }
+	UInt32			capacity() const { return UInt32(_slots.size()); }
+
+	iterator		begin() { return iterator(_slots, 0); }
+	iterator		end() { return iterator(_slots, capacity()); }
+	const_iterator	begin() const { return const_iterator(_slots, 0); }
+	const_iterator	end() const { return const_iterator(_slots, capacity()); }
+
+	iterator		find(const KeyType& key) { return iterator(_slots, search(key, Hash(key))); }
+	const_iterator	find(const KeyType& key) const { return const_iterator(_slots, search(key, Hash(key))); }
+	UInt32			count(const KeyType& key) const { return search(key, Hash(key)) < capacity() ? 1 : 0; }
+
+	/*!
+	Insert if key is not already present, returns the entry of key and true if inserted */
+	std::pair<iterator, bool> emplace(const KeyType& key, const ValueType& value) {
+		UInt32 hash(Hash(key));
+		UInt32 index(search(key, hash));
+		if (index < capacity())
+			return std::make_pair(iterator(_slots, index), false);
+		if (((_size + 1) << 2) > (capacity() * 3))
+			reset(capacity() << 1);
+		Slot& slot(_slots[index = free(hash)]);
+		slot.hash = hash;
+		slot.entry.first = key;
+		slot.entry.second = value;
+		++_size;
+		return std::make_pair(iterator(_slots, index), true);
+	}
+	UInt32 erase(const KeyType& key) {
+		UInt32 index(search(key, Hash(key)));
+		if (index >= capacity())
+			return 0;
+		remove(index);
+		return 1;
+	}
+	void erase(const iterator& it) { remove(it.index()); }
+
+	void clear() {
+		_slots = std::vector<Slot>(16);
+		_mask = 15;
+		_size = 0;
+	}
+
+private:
+	static UInt32 Hash(const KeyType& key) {
+		UInt32 hash(UInt32(Hasher()(key)));
+		return hash ? hash : 1;
+	}
+	/*!
+	Index of key, or capacity() if not found */
+	UInt32 search(const KeyType& key, UInt32 hash) const {
+		for (UInt32 index = hash & _mask; _slots[index].hash; index = (index + 1) & _mask) {
+			if (_slots[index].hash == hash && Equal()(_slots[index].entry.first, key))
+				return index;
+		}
+		return capacity();
+	}
+	UInt32 free(UInt32 hash) const {
+		UInt32 index(hash & _mask);
+		while (_slots[index].hash)
+			index = (index + 1) & _mask;
+		return index;
+	}
+	void remove(UInt32 index) {
+		// backward shift: move back the following entries of the cluster which can be nearest their ideal slot
+		for (UInt32 next = (index + 1) & _mask; _slots[next].hash; next = (next + 1) & _mask) {
+			UInt32 ideal(_slots[next].hash & _mask);
+			if (((next - ideal) & _mask) < ((next - index) & _mask))
+				continue; // ideal slot is in ]index, next], can't move before
+			_slots[index] = std::move(_slots[next]);
+			index = next;
+		}
+		_slots[index] = Slot(); // release key and value
+		--_size;
+	}
+	void reset(UInt32 capacity) {
+		UInt32 power(16);
+		while (power < capacity)
+			power <<= 1;
+		std::vector<Slot> slots(power);
+		std::swap(_slots, slots);
+		_mask = power - 1;
+		for (Slot& slot : slots) {
+			if (slot.hash)
+				_slots[free(slot.hash)] = std::move(slot);
+		}
+	}
+
+	std::vector<Slot>	_slots;
+	UInt32				_mask;
+	UInt32				_size;
+};
+
+
+} // namespace Mona
@@ -31,6 +31,10 @@ It uses a Thread::ProcessorCount() threads with low priority to load/read/write
 Indeed even if SSD drive allows parallel reading and writing operation every operation sollicate too the CPU,
 so it's useless to try to exceeds number of CPU core (Thread::ProcessorCount() has been tested and approved with file load) */
 struct IOFile : virtual Object, Thread { // Thread is for file watching!
+	enum Backend {
+		BACKEND_SYSTEM = 0, // blocking writings on IOFile threads
+		BACKEND_URING // io_uring on Linux (>= 5.13), writings of loaded files are submitted by batch to the ring by its own thread
+	};
 
 	IOFile(const Handler& handler, const ThreadPool& threadPool, UInt16 cores=0);
 	~IOFile();
@@ -38,6 +42,12 @@ struct IOFile : virtual Object, Thread { // Thread is for file watching!
 	const Handler&	  handler;
 	const ThreadPool& threadPool;
 
+	/*!
+	Change the backend used to write files, to call before any file operation.
+	Returns false if the backend is not supported by the system */
+	bool	setBackend(Backend backend);
+	Backend	backend() const { return _pRing ? BACKEND_URING : BACKEND_SYSTEM; }
+
 	/*!
 	Subscribe read */
 	template<typename FileType>
@@ -57,12 +67,14 @@ struct IOFile : virtual Object, Thread { // Thread is for file watching!
 	Subscribe write/delete */
 	void subscribe(const shared<File>& pFile, const File::OnError& onError, const File::OnFlush& onFlush = nullptr);
 	/*!
-	Unsubscribe */
+	Unsubscribe, the last block of a direct file is written by the IOFile queue (see File::setDirect) */
 	template<typename FileType>
 	void unsubscribe(shared<FileType>& pFile) {
 		pFile->_onFlush = nullptr;
 		pFile->_onReaden = nullptr;
 		pFile->_onError = nullptr;
+		if (pFile->direct())
+			endDirect(pFile);
 		pFile.reset();
 	}
 	/*!
@@ -73,7 +85,8 @@ struct IOFile : virtual Object, Thread { // Thread is for file watching!
 	size default = 0xFFFF (Best buffer performance, see http://zabkat.com/blog/buffered-disk-access.htm) */
 	void read(const shared<File>& pFile, UInt32 size=0xFFFF);
 	/*!
-	Async write with file load if file not loaded */
+	Async write with file load if file not loaded,
+	packets written meanwhile a previous writing are gathered in one system call */
 	void write(const shared<File>& pFile, const Packet& packet);
 	/*!
 	Async file/folder deletion*/
@@ -88,15 +101,20 @@ struct IOFile : virtual Object, Thread { // Thread is for file watching!
 	void join();
 private:
 	bool run(Exception& ex, const volatile bool& requestStop);
+	/*!
+	Write the last incomplete block of a direct file after its queued writings, on its IOFile thread */
+	void endDirect(const shared<File>& pFile);
 
 	struct Action;
 	struct WAction;
 	struct SAction;
+	struct Ring;
 
 
 	ThreadPool								_threadPool; // Pool of threads for writing/reading disk operation
 	std::vector<shared<const FileWatcher>>	_watchers;
 	std::mutex								_mutexWatchers;
+	unique<Ring>							_pRing;
 };
 
 
@@ -21,18 +21,39 @@ details (or else see http://mozilla.org/MPL/2.0/).
 #include "Mona/Thread.h"
 #include "Mona/ThreadPool.h"
 #include "Mona/Socket.h"
+#include <vector>
 
 namespace Mona {
 
 struct IOSRTSocket;
 struct IOSocket : protected Thread, virtual Object {
+	enum Backend {
+		BACKEND_SYSTEM = 0, // epoll on Linux, kqueue on BSD and WSAAsyncSelect on Windows
+		BACKEND_URING // io_uring on Linux (>= 5.19), accept, recv and send submitted on the ring (see setBackend)
+	};
+
 	IOSocket(const Handler& handler, const ThreadPool& threadPool, const char* name = "IOSocket");
 	~IOSocket();
 
 	const Handler&			handler;
 	const ThreadPool&		threadPool;
 
-	UInt32					subscribers() const { return _subscribers; }
+	UInt32					subscribers() const;
+
+	/*!
+	Sharded mode, shards reactor threads with one epoll set each, a socket is assigned on subscription to the shard matching its Socket::_threadReceive
+	to keep reception, decoding and flush of one socket on the same thread. Must be set before any subscription, 0 or 1 = one reactor.
+	Fails with Ex::Intern if sockets are already subscribed, or with Ex::Unsupported if the platform doesn't support it (epoll only) */
+	bool					setShards(Exception& ex, UInt16 shards);
+	UInt16					shards() const { return UInt16(_shards.size()); }
+
+	/*!
+	Select the system of the reactor, must be set before any subscription (applied to shards too).
+	With BACKEND_URING the listening sockets accept on the ring, and the connected TCP sockets without TLS receive in buffers provided to the ring
+	(allocated by Buffer::Allocator, so by BufferPool when set) and send their queue on the ring, other sockets are polled on the ring.
+	Fails with Ex::Intern if sockets are already subscribed, or with Ex::Unsupported if the system doesn't support it */
+	bool					setBackend(Exception& ex, Backend backend);
+	Backend					backend() const { return _backend; }
 
 	bool					subscribe(Exception& ex, const shared<Socket>& pSocket,
 								const Socket::OnReceived& onReceived,
@@ -96,6 +117,16 @@ private:
 			const Socket::OnError& onError);
 	
 	virtual bool run(Exception& ex, const volatile bool& requestStop);
+	IOSocket&	 shard(Socket& socket);
+#if !defined(_WIN32) && !defined(_BSD)
+	void		 process(const shared<Socket>& pSocket, UInt32 events);
+#endif
+	/*!
+	Flush request of Socket::write in batched flush mode */
+	void flush(Socket& socket);
+	/*!
+	Sending request of Socket::write in io_uring mode, the socket is kept alive until the end of its sending */
+	void send(Socket& socket);
 
 #if defined(_WIN32)
 	std::map<NET_SOCKET, weak<Socket>>	_sockets;
@@ -106,8 +137,17 @@ private:
 
 	NET_SYSTEM									_system;
 	shared<IOSRTSocket>							_pIOSRTSocket;
+	std::vector<unique<IOSocket>>				_shards;
+	std::atomic<UInt16>							_nextThread;
+	bool										_pinned; // actions of a socket are queued on its _threadReceive (shard)
+	Backend										_backend;
+
+	struct Ring;
+	unique<Ring>								_pRing;
+	std::mutex									_mutexRing; // protects _pRing and its requests
 
 	struct Action;
+	friend struct Socket;
 };
 
 
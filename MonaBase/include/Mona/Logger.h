@@ -46,12 +46,19 @@ struct Logger : virtual Object {
 	/*!
 	Test if always valid */
 	virtual bool enabled() const { return true; }
+	/*!
+	Binary logger receives raw dump data rather than its hexadecimal text,
+	and when at least one is enabled dumps are reserved to binary loggers (hexadecimal formatting is the expensive part) */
+	virtual bool binary() const { return false; }
 
 	const char* name;
 	const char* fatal;
 
 	virtual bool log(LOG_LEVEL level, const Path& file, long line, const std::string& message) = 0;
 	virtual bool dump(const std::string& header, const UInt8* data, UInt32 size) = 0;
+	/*!
+	Write what is buffered, called after each synchronous log or dump and after each batch of asynchronous logs */
+	virtual bool flush() { return true; }
 };
 
 } // namespace Mona
@@ -20,6 +20,7 @@ details (or else see http://mozilla.org/MPL/2.0/).
 #include "Mona/ConsoleLogger.h"
 #include "Mona/String.h"
 #include "Mona/Thread.h"
+#include "Mona/Time.h"
 #include <atomic>
 
 namespace Mona {
@@ -61,7 +62,7 @@ struct Logs : virtual Static {
 		return Strings[level];
 	}
 
-	static void			SetDumpLimit(Int32 limit) { std::lock_guard<std::mutex> lock(_Mutex); _DumpLimit = limit; }
+	static void			SetDumpLimit(Int32 limit) { _DumpLimit = limit; }
 	static void			SetDump(const char* name); // if null, no dump, otherwise dump name, and if name is empty everything is dumped
 	static const char*	GetDump();
 
@@ -70,38 +71,70 @@ struct Logs : virtual Static {
 	
 	static bool			LastCritic(std::string& critic);
 
+	/*!
+	Asynchronous logs: each thread formats its logs in its own lock-free ring of capacity slots (rounded up to a power of 2),
+	and a background thread drains rings to loggers. A log on a full ring is dropped and counted (see Dropped).
+	Dumps are copied in the rings too, FATAL and CRITIC stay synchronous (they write the rings before to keep the order).
+	Capacity 0 returns to synchronous logs after a last drain */
+	static void			SetAsync(UInt32 capacity);
+	static UInt32		GetAsync() { return _AsyncCapacity; }
+	/*!
+	Count of logs dropped on full ring since the start */
+	static UInt64		Dropped() { return _Dropped; }
+	/*!
+	Id of the thread which has emitted the log in writing, to use in Logger implementation rather than Thread::CurrentId() */
+	static UInt32		ThreadId() { return _ThreadId ? _ThreadId : Thread::CurrentId(); }
+	/*!
+	Time of the log in writing (emission time), to use in Logger implementation rather than Time::Now() */
+	static Int64		Now() { return _Time ? _Time : Time::Now(); }
+
 	template <typename ...Args>
     static void	Log(LOG_LEVEL level, const char* file, long line, Args&&... args) {
 		if (_Logging || _Level < level)
 			return;
 		_Logging = true;
+		if (level > LOG_CRITIC && _AsyncCapacity) {
+			bool full(false);
+			std::string* pMessage = Reserve(full);
+			if (pMessage) {
+				String::Assign(*pMessage, std::forward<Args>(args)...);
+				Commit(level, file, line);
+			}
+			if (pMessage || full) {
+				_Logging = false;
+				return;
+			} // else asynchronous logs stopped meanwhile
+		}
+		if (_AsyncCapacity || _PRing)
+			Drain(); // previous logs of the rings before this synchronous one
 		std::lock_guard<std::mutex> lock(_Mutex);
-		static Path File;
 		static String Message;
-		File.set(file);
 		String::Assign(Message, std::forward<Args>(args)...);
-		if (level <= LOG_CRITIC)
-			_Critic.assign(Message.empty() ? "unknown" : Message.c_str());
-		for (auto& it : _Loggers) {
-			if (*it.second && !it.second->log(level, File, line, Message))
-				_Loggers.fail(*it.second);
-		}
-		if(Message.size()>0xFF) {
-			Message.resize(0xFF);
-			Message.shrink_to_fit();
-		}
-		_Loggers.flush();
+		Write(level, file, line, Message);
 		_Logging = false;
 	}
 
 	template <typename ...Args>
 	static void Dump(const char* name, const UInt8* data, UInt32 size, Args&&... args) {
-		if (!_Dump || _Dumping)
+		if (!_Dump || _Dumping || !Filtered(name))
 			return;
 		_Dumping = true;
+		if (_AsyncCapacity && !_Logging) { // _Logging => a log is in reservation in the ring of this thread
+			_Logging = true; // no log in the ring while this dump is in reservation
+			bool full(false);
+			std::string* pMessage = Reserve(full);
+			if (pMessage) {
+				String::Assign(*pMessage, std::forward<Args>(args)...);
+				CommitDump(data, size);
+			}
+			_Logging = false;
+			if (pMessage || full) {
+				_Dumping = false;
+				return;
+			} // else asynchronous logs stopped meanwhile
+		}
 		std::lock_guard<std::mutex> lock(_Mutex);
-		if (_DumpFilter.empty() || String::ICompare(_DumpFilter, name) == 0)
-			Dump(String(std::forward<Args>(args)...), data, size);
+		Dump(String(std::forward<Args>(args)...), data, size);
 		_Dumping = false;
 	}
 	template <typename ...Args>
@@ -144,9 +177,34 @@ struct Logs : virtual Static {
 	};
 
 private:
-	static void		Dump(const std::string& header, const UInt8* data, UInt32 size);
+	/*!
+	Dispatch a dump to loggers, _Mutex must be locked, flush = false for a batch (see Logger::flush) */
+	static void		Dump(const std::string& header, const UInt8* data, UInt32 size, bool flush = true);
+	/*!
+	Dispatch a log to loggers, _Mutex must be locked, flush = false for a batch (see Logger::flush) */
+	static void		Write(LOG_LEVEL level, const char* file, long line, std::string& message, bool flush = true);
+	/*!
+	True if name passes the dump filter, lock-free */
+	static bool		Filtered(const char* name);
+	/*!
+	Thread copy of the dump filter, refreshed on SetDump */
+	static const std::string& DumpFilter();
 
-	static std::mutex				_Mutex;
+	struct Ring;
+	struct Drainer;
+	/*!
+	Message of the next slot in the thread ring, NULL if ring is full (full = true, log dropped)
+	or if asynchronous logs are stopped (synchronous fallback) */
+	static std::string*	Reserve(bool& full);
+	static void			Commit(LOG_LEVEL level, const char* file, long line);
+	/*!
+	Commit a dump, message reserved is its header */
+	static void			CommitDump(const UInt8* data, UInt32 size);
+	/*!
+	Write the logs of all the rings now */
+	static void			Drain();
+
+	static std::mutex				_Mutex; // loggers and writing, never taken by an asynchronous log or dump
 	static std::string				_Critic;
 
 	static thread_local bool		_Logging;
@@ -155,18 +213,29 @@ private:
 	static std::atomic<LOG_LEVEL>	_Level;
 	static struct Loggers : std::map<std::string, unique<Logger>, String::IComparator>, virtual Object {
 		Loggers() { self["console"].set<ConsoleLogger>(); }
-		void fail(Logger& logger) { _failed.emplace_back(&logger); }
+		void fail(Logger& logger);
+		/*!
+		Flush loggers and remove the failed ones */
 		void flush();
 	private:
 		std::vector<Logger*> _failed;
 	}								_Loggers;
 
+	static std::atomic<UInt32>			_AsyncCapacity;
+	static std::atomic<UInt64>			_Dropped;
+	static thread_local UInt32			_ThreadId; // emitter thread id while draining
+	static thread_local Int64			_Time; // emission time while draining
+	static thread_local shared<Ring>	_PRing;
+	static Drainer						_Drainer;
+
+	static std::mutex			_DumpMutex; // protect _DumpFilter, taken on change only
 	static std::string			_DumpFilter; // empty() means all dump, otherwise is a dump filter
+	static std::atomic<UInt32>	_DumpVersion; // incremented on SetDump to refresh the thread copies
 	static volatile bool		_Dump;
 
 	static volatile bool		_DumpRequest;
 	static volatile bool		_DumpResponse;
-	static Int32				_DumpLimit; // -1 means no limit
+	static std::atomic<Int32>	_DumpLimit; // -1 means no limit
 };
 
 #undef ERROR
@@ -0,0 +1,120 @@
+/*
+This file is a part of MonaSolutions Copyright 2017
+mathieu.poux[a]gmail.com
+jammetthomas[a]gmail.com
+
+This program is free software: you can redistribute it and/or
+modify it under the terms of the the Mozilla Public License v2.0.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+Mozilla Public License v. 2.0 received along this program for more
+details (or else see http://mozilla.org/MPL/2.0/).
+
+*/
+
+#pragma once
+
+#include "Mona/Mona.h"
+#include <atomic>
+#include <thread>
+#include <deque>
+
+namespace Mona {
+
+/*!
+Lock-free unbounded queue with multiple producers and one consumer (linked list of D. Vyukov),
+push signals the transition from empty to non-empty to coalesce the wake-ups of the consumer:
+after a pop returning false (empty) the consumer can wait, the next push will return true to wake it up */
+template<typename Type>
+struct MPSCQueue : virtual Object {
+	MPSCQueue() : _pHead(&_stub), _pTail(&_stub), _count(0), _contentions(0), _wakeUps(0) {}
+	~MPSCQueue() {
+		Type value;
+		while (pop(value));
+		if (_pTail != &_stub)
+			delete _pTail;
+	}
+
+	/*!
+	Values pushed and not popped, can be negative temporarily (value popped before its producer has counted it) */
+	Int32 count() const { return _count.load(std::memory_order_acquire); }
+	/*!
+	Times where the consumer has had to wait the end of a producer push */
+	UInt64 contentions() const { return _contentions; }
+	/*!
+	Times where a push has returned true to wake up the consumer */
+	UInt64 wakeUps() const { return _wakeUps; }
+
+	/*!
+	Push a value, thread-safe, returns true if the consumer has to be waked up (queue was empty) */
+	template<typename ValueType>
+	bool push(ValueType&& value) {
+		Node* pNode = new Node(std::forward<ValueType>(value));
+		_pHead.exchange(pNode, std::memory_order_acq_rel)->pNext.store(pNode, std::memory_order_release);
+		// count after linking, a consumer which sees a count > 0 is sure to find the node
+		if (_count.fetch_add(1, std::memory_order_acq_rel) > 0)
+			return false;
+		++_wakeUps;
+		return true;
+	}
+	/*!
+	Pop one value, consumer thread only, returns false if empty */
+	bool pop(Type& value) {
+		Node* pNext = _pTail->pNext.load(std::memory_order_acquire);
+		if (!pNext) {
+			if (_pHead.load(std::memory_order_acquire) == _pTail)
+				return false;
+			// a producer is between exchange and link, it's a matter of instructions
+			++_contentions;
+			while (!(pNext = _pTail->pNext.load(std::memory_order_acquire)))
+				std::this_thread::yield();
+		}
+		value = std::move(pNext->value);
+		if (_pTail != &_stub)
+			delete _pTail;
+		_pTail = pNext; // becomes the new stub
+		_count.fetch_sub(1, std::memory_order_acq_rel);
+		return true;
+	}
+	/*!
+	Pop in one batch the values available now, consumer thread only,
+	returns true if values remain, in this case no wake-up will come for them: pop again before to wait! */
+	bool pop(std::deque<Type>& values) {
+		// bound to the count to keep a batch finite when producers never stop
+		for (Int32 count = _count.load(std::memory_order_acquire); count > 0; --count) {
+			values.emplace_back();
+			if (pop(values.back()))
+				continue;
+			values.pop_back();
+			break;
+		}
+		return _count.load(std::memory_order_acquire) > 0;
+	}
+	/*!
+	Remove all values, consumer thread only */
+	void clear() {
+		Type value;
+		while (pop(value));
+	}
+
+private:
+	struct Node : virtual Object {
+		Node() : pNext(NULL) {}
+		template<typename ValueType>
+		Node(ValueType&& value) : value(std::forward<ValueType>(value)), pNext(NULL) {}
+		Type				value;
+		std::atomic<Node*>	pNext;
+	};
+
+	std::atomic<Node*>		_pHead;
+	Node*					_pTail;
+	Node					_stub;
+	std::atomic<Int32>		_count;
+	std::atomic<UInt64>		_contentions;
+	std::atomic<UInt64>		_wakeUps;
+};
+
+
+} // namespace Mona
@@ -229,6 +229,11 @@ struct Net : virtual Object {
 
 		virtual UInt64	queueing() const = 0;
 
+		/*!
+		Average of datagrams received and sent by system call (batched UDP I/O), 0 if not applicable */
+		virtual double	recvBatchSize() const { return 0; }
+		virtual double	sendBatchSize() const { return 0; }
+
 		static Stats& Null();
 	};
 
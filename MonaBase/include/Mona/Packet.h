@@ -19,6 +19,7 @@ details (or else see http://mozilla.org/MPL/2.0/).
 #include "Mona/Mona.h"
 #include "Mona/Buffer.h"
 #include "Mona/Exceptions.h"
+#include <atomic>
 
 namespace Mona {
 /*!
@@ -83,7 +84,7 @@ struct Packet: Binary, virtual Object {
 	explicit Packet(shared<BinaryType>& pBuffer, const UInt8* data, UInt32 size) : _reference(true) { set(pBuffer, data, size); }
 	/*!
 	Release the referenced area of data */
-	virtual ~Packet() { if (!_reference) delete _ppBuffer; }
+	virtual ~Packet() { if (!_reference) ((Holder*)_ppBuffer)->release(); }
 	/*!
 	Allow to compare data packet*/
 	bool operator == (const Packet& packet) const { return _size == packet._size && ((_size && memcmp(_data, packet._data, _size)==0) || _data == packet._data); }
@@ -176,11 +177,11 @@ struct Packet: Binary, virtual Object {
 		if (!pBuffer || !pBuffer->data())  // if pBuffer->size==0 the normal behavior is required to get the same data address
 			return set(NULL, 0);
 		if (!_reference)
-			delete _ppBuffer;
+			((Holder*)_ppBuffer)->release();
 		_reference = typeid(Binary) == typeid(BinaryType);
 		_data = pBuffer->data();
 		_size = pBuffer->size();
-		_ppBuffer = _reference ? (shared<const Binary>*)&pBuffer : new shared<const Binary>(pBuffer);
+		_ppBuffer = _reference ? (shared<const Binary>*)&pBuffer : new Holder(pBuffer);
 		return self;
 	}
 	/*!
@@ -196,12 +197,12 @@ struct Packet: Binary, virtual Object {
 		if (!pBuffer || !pBuffer->data()) // if size==0 the normal behavior is required to get the same data address
 			return set(NULL, 0); // no need here to capture pBuffer (no holder on)
 		if (!_reference)
-			delete _ppBuffer;
+			((Holder*)_ppBuffer)->release();
 		else
 			_reference = false;
 		_data = pBuffer->data();
 		_size = pBuffer->size();
-		_ppBuffer = new shared<const Binary>(move(pBuffer)); // forbid now all changes by caller!
+		_ppBuffer = new Holder(std::move(pBuffer)); // forbid now all changes by caller!
 		return self;
 	}
 	/*!
@@ -214,7 +215,20 @@ struct Packet: Binary, virtual Object {
 	static const Packet& Null() { static Packet Null(nullptr); return Null; }
 
 private:
-	Packet(std::nullptr_t) : _ppBuffer(new shared<const Binary>()), _data(NULL), _size(0), _reference(false) {}
+	Packet(std::nullptr_t) : _ppBuffer(&NullBuffer()), _data(NULL), _size(0), _reference(true) {}
+	static const shared<const Binary>& NullBuffer() { static const shared<const Binary> PNull; return PNull; }
+
+	/*!
+	Buffer captured with an intrusive counter of the packets which share it, apart from Binary to not grow every buffer.
+	Allocated once by capture, then distributing a bufferized packet costs just one atomic increment */
+	struct Holder : shared<const Binary> {
+		template<typename BufferType>
+		Holder(BufferType&& pBuffer) : shared<const Binary>(std::forward<BufferType>(pBuffer)) { _count.store(1, std::memory_order_release); } // published after the buffer assignment
+		Holder* share() { _count.fetch_add(1, std::memory_order_acquire); return this; }
+		void	release() { if (_count.fetch_sub(1, std::memory_order_acq_rel) == 1) delete this; }
+	private:
+		std::atomic<UInt32> _count;
+	};
 
 	Packet& setArea(const UInt8* data, UInt32 size);
 
@@ -0,0 +1,106 @@
+/*
+This file is a part of MonaSolutions Copyright 2017
+mathieu.poux[a]gmail.com
+jammetthomas[a]gmail.com
+
+This program is free software: you can redistribute it and/or
+modify it under the terms of the the Mozilla Public License v2.0.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+Mozilla Public License v. 2.0 received along this program for more
+details (or else see http://mozilla.org/MPL/2.0/).
+
+*/
+
+#pragma once
+
+#include "Mona/Mona.h"
+#include "Mona/Packet.h"
+#include <memory>
+
+namespace Mona {
+
+/*!
+Chain of packets (scatter-gather list) to write in one gathered system call without copying data,
+typically a small header built on the fly followed by the media payload.
+Packet appended is bufferized (just a reference increment when already buffered), empty packet is ignored.
+Implicitly constructible from a Packet to keep a single packet writable where a chain is expected.
+The first packets are stored inline without allocation (header + a few slices), the heap is used just beyond. */
+struct Packets : virtual Object {
+	typedef const Packet* const_iterator;
+
+	Packets() : _capacity(0), _count(0), _size(0) {}
+	Packets(const Packet& packet) : _capacity(0), _count(0), _size(0) { append(packet); }
+
+	/*!
+	Total size of the chain */
+	UInt32			size() const { return _size; }
+	/*!
+	Count of packets chained */
+	UInt32			count() const { return _count; }
+	operator bool() const { return _size ? true : false; }
+
+	const Packet&	operator[](UInt32 index) const { return begin()[index]; }
+	const Packet&	front() const { return *begin(); }
+	const Packet&	back() const { return end()[-1]; }
+	const_iterator	begin() const { return _pHeap ? _pHeap.get() : _inline; }
+	const_iterator	end() const { return begin() + _count; }
+
+	Packets& append(const Packet& packet) {
+		if (!packet)
+			return self;
+		if (_count < INLINE_COUNT)
+			_inline[_count].set(std::move(packet));
+		else {
+			if (_count >= _capacity) {
+				// spill to the heap, packets are bufferized again (a Packet copy would be just a reference on its source)
+				Packet* pHeap = new Packet[_capacity = _count * 2];
+				Packet* pPackets = _pHeap ? _pHeap.get() : _inline;
+				for (UInt32 i = 0; i < _count; ++i)
+					pHeap[i].set(std::move(pPackets[i]));
+				if (!_pHeap) {
+					for (Packet& inlined : _inline)
+						inlined.reset();
+				}
+				_pHeap.reset(pHeap);
+			}
+			_pHeap[_count].set(std::move(packet));
+		}
+		++_count;
+		_size += packet.size();
+		return self;
+	}
+	Packets& append(const Packets& packets) {
+		for (const Packet& packet : packets)
+			append(packet);
+		return self;
+	}
+	Packets& operator+=(const Packet& packet) { return append(packet); }
+	Packets& operator+=(const Packets& packets) { return append(packets); }
+
+	Packets& reset() {
+		if (_pHeap) {
+			_pHeap.reset();
+			_capacity = 0;
+		} else {
+			for (UInt32 i = 0; i < _count; ++i)
+				_inline[i].reset();
+		}
+		_size = _count = 0;
+		return self;
+	}
+
+private:
+	enum { INLINE_COUNT = 4 };
+
+	Packet						_inline[INLINE_COUNT];
+	std::unique_ptr<Packet[]>	_pHeap; // all the packets once more than INLINE_COUNT
+	UInt32						_capacity; // of _pHeap
+	UInt32						_count;
+	UInt32						_size;
+};
+
+
+} // namespace Mona
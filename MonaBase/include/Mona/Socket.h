@@ -19,13 +19,15 @@ details (or else see http://mozilla.org/MPL/2.0/).
 #include "Mona/Mona.h"
 #include "Mona/SocketAddress.h"
 #include "Mona/ByteRate.h"
-#include "Mona/Packet.h"
+#include "Mona/Packets.h"
 #include "Mona/Handler.h"
 #include "Mona/Parameters.h"
 #include <deque>
 
 namespace Mona {
 
+struct IOSocket;
+struct File;
 struct Socket : virtual Object, Net::Stats {
 	typedef Event<void(shared<Buffer>& pBuffer, const SocketAddress& address)>	  OnReceived;
 	typedef Event<void(const shared<Socket>& pSocket)>							  OnAccept;
@@ -39,6 +41,12 @@ struct Socket : virtual Object, Net::Stats {
 	/!\ pSocket must never be "attached" to the decoder in a instance variable otherwise a memory leak could happen (however a weak attachment stays acceptable) */
 	struct Decoder : virtual Object {
 		virtual void decode(shared<Buffer>& pBuffer, const SocketAddress& address, const shared<Socket>& pSocket) = 0;
+		/*!
+		Datagrams received by the same system call (see Socket::RECV_BATCH_MAX), overloads it to decode them in one pass */
+		virtual void decodeBatch(shared<Buffer>* pBuffers, const SocketAddress* addresses, UInt32 count, const shared<Socket>& pSocket) {
+			for (UInt32 i = 0; i < count; ++i)
+				decode(pBuffers[i], addresses[i], pSocket);
+		}
 		virtual void onRelease(Socket& socket) {}
 	};
 
@@ -55,7 +63,14 @@ struct Socket : virtual Object, Net::Stats {
 	};
 
 	enum {
-		BACKLOG_MAX = 200 // blacklog maximum, see http://tangentsoft.net/wskfaq/advanced.html#backlog
+		BACKLOG_MAX = 200, // blacklog maximum, see http://tangentsoft.net/wskfaq/advanced.html#backlog
+		RECV_BATCH_MAX = 32, // datagrams maximum received by one system call (recvmmsg)
+		RECV_SPILL_SIZE = 0xFFFF, // bytes of the spill area behind each batch slot, over the maximum UDP payload
+		RECV_SLOT_MIN = 2048, // bytes minimum of a batch slot, greater than max possible MTU (~1500 bytes)
+		RECV_SLOT_DECAY = 64, // batches without datagram bigger than the half slot to halve it
+		SEND_BATCH_MAX = 64, // datagrams maximum sent by one system call on flush (sendmmsg)
+		SEND_GATHER_MAX = 64, // packets maximum gathered by one system call on stream socket (sendmsg), under IOV_MAX (1024 on Linux and BSD)
+		GSO_SIZE_MAX = 0xFFFF - 48 // bytes maximum of datagrams gathered by UDP generic segmentation offload (0xFFFF - IPv6 and UDP headers)
 	};
 
 	/*!
@@ -69,12 +84,22 @@ struct Socket : virtual Object, Net::Stats {
 	operator NET_SOCKET() const { return _id; }
 
 	virtual bool		isSecure() const { return false; }
+	/*!
+	True when a secure socket lets the kernel encrypt its sendings (kTLS), it can then send without user space copy */
+	virtual bool		isKernelSecure() const { return false; }
 
 	Time				recvTime() const { return _recvTime.load(); }
 	UInt64				recvByteRate() const { return _recvByteRate; }
 	Time				sendTime() const { return _sendTime.load(); }
 	UInt64				sendByteRate() const { return _sendByteRate; }
 
+	/*!
+	Average of datagrams received by system call, shows the syscall savings of batched reception */
+	double				recvBatchSize() const { UInt64 batches(_recvBatches); return batches ? double(_recvBatched) / batches : 0; }
+	/*!
+	Average of datagrams sent by batched system call on flush (sendmmsg) */
+	double				sendBatchSize() const { UInt64 batches(_sendBatches); return batches ? double(_sendBatched) / batches : 0; }
+
 	UInt32				recvBufferSize() const { return _recvBufferSize; }
 	UInt32				sendBufferSize() const { return _sendBufferSize; }
 
@@ -114,6 +139,23 @@ struct Socket : virtual Object, Net::Stats {
 	void setReusePort(bool value);
 	bool getReusePort() const;
 
+	/*!
+	Batched flush mode for datagram socket subscribed to IOSocket: write queues the packet and lets IOSocket flush in one system call
+	all the packets written meanwhile, whatever their destination address */
+	void setSendBatch(bool value) { _sendBatch = value; }
+	bool getSendBatch() const { return _sendBatch; }
+
+	/*!
+	Zero-copy sending (MSG_ZEROCOPY, Linux >= 4.14) of TCP packets from minSize bytes, 0 disables it (default),
+	a packet is held until the kernel signals the end of its transmission on the error queue (drained by IOSocket).
+	Worth just for large packets (~10KB and more) because of the page pinning and completion costs, Ex::Unsupported with TLS
+	or with a socket sending by the io_uring backend of IOSocket */
+	bool   setZeroCopy(Exception& ex, UInt32 minSize);
+	UInt32 getZeroCopy() const { return _zeroCopy; }
+	/*!
+	Count of packets held by zero-copy sendings in progress */
+	UInt32 zeroCopying() const { std::lock_guard<std::mutex> lock(_mutexSending); return UInt32(_zeroCopies.size()); }
+
 	virtual bool setNonBlockingMode(Exception& ex, bool value);
 	bool getNonBlockingMode() const { return _nonBlockingMode; }
 
@@ -136,6 +178,11 @@ struct Socket : virtual Object, Net::Stats {
 	
 	int			 receive(Exception& ex, void* buffer, UInt32 size, int flags = 0) { return receive(ex, buffer, size, flags, NULL); }
 	int			 receiveFrom(Exception& ex, void* buffer, UInt32 size, SocketAddress& address, int flags = 0)  { return receive(ex, buffer, size, flags, &address); }
+	/*!
+	Receive until count datagrams in one system call when possible (recvmmsg), pBuffers are allocated or resized to fit the datagrams received.
+	Only the slots likely filled are prepared: the count by call starts at 1, doubles while batches are full and restarts from the last count otherwise.
+	Returns the number of datagrams received or -1 on error, a datagram truncated is dropped and signaled with a NET_EMSGSIZE exception */
+	int			 receive(Exception& ex, shared<Buffer>* pBuffers, SocketAddress* addresses, UInt32 count);
 
 	int			 send(Exception& ex, const void* data, UInt32 size, int flags = 0) { return sendTo(ex, data, size, SocketAddress::Wildcard(), flags); }
 	virtual int	 sendTo(Exception& ex, const void* data, UInt32 size, const SocketAddress& address, int flags=0);
@@ -145,9 +192,22 @@ struct Socket : virtual Object, Net::Stats {
 	Returns size of data sent immediatly (or -1 if error, for TCP socket a SHUTDOWN_SEND is done, so socket will be disconnected) */
 	int			 write(Exception& ex, const Packet& packet, int flags = 0) { return write(ex, packet, SocketAddress::Wildcard(), flags); }
 	int			 write(Exception& ex, const Packet& packet, const SocketAddress& address, int flags = 0);
+	/*!
+	Sequential and safe writing of a chain of packets, on TCP socket (without zero-copy and without TLS or with kernel TLS) the chain is queued and sent
+	in one gathered system call (sendmsg) without copying data, on datagram socket the chain is one datagram.
+	Returns size of data sent immediatly (or -1 if error, for TCP socket a SHUTDOWN_SEND is done) */
+	int			 write(Exception& ex, const Packets& packets, int flags = 0) { return write(ex, packets, SocketAddress::Wildcard(), flags); }
+	int			 write(Exception& ex, const Packets& packets, const SocketAddress& address, int flags = 0);
 
 	bool		 flush(Exception& ex) { return flush(ex, false); }
 
+	/*!
+	Zero-copy sending of the next size bytes of file (sendfile on Linux) from its reading position, for TCP socket without TLS or with kernel TLS.
+	Sends nothing while data are queueing to keep order, returns size sent (0 on congestion, wait onFlush) or -1 if error,
+	Ex::Unsupported if the socket or the platform can't do it (use write rather, always the case with a socket sending by the io_uring backend of IOSocket),
+	Ex::System::File if the file ends before size */
+	int			 sendFile(Exception& ex, File& file, UInt32 size);
+
 	template <typename ...Args>
 	static Exception& SetException(int error, Exception& ex, Args&&... args) {
 		if (!error)
@@ -192,6 +252,22 @@ protected:
 private:
 	virtual bool setIPV6Only(Exception& ex, bool enable) { return setOption(ex, IPPROTO_IPV6, IPV6_V6ONLY, enable ? 1 : 0); }
 	virtual void computeAddress();
+	/*!
+	Sends the front queued datagrams with same flags in one system call (sendmmsg), removes of the queue the datagrams sent and increments written with their size.
+	Runs of datagrams with same size to the same destination are sent as one GSO message (UDP_SEGMENT).
+	Returns the number of datagrams sent or -1 on error for the first one */
+	int			 sendBatch(Exception& ex, UInt32& written);
+	/*!
+	Sends the front queued packets of stream socket with same flags in one system call (sendmsg), removes of the queue the packets sent,
+	moves the area of the packet partially sent and increments written with the size sent.
+	Returns the number of packets sent, 0 if all the packets gathered have not been sent (congestion) or -1 on error */
+	int			 sendGather(Exception& ex, UInt32& written);
+	/*!
+	Sends packet with MSG_ZEROCOPY and holds it until completion, _mutexSending must be locked */
+	int			 sendZeroCopy(Exception& ex, const Packet& packet, int flags);
+	/*!
+	Reads zero-copy completions on the error queue to release the packets sent (called by IOSocket on EPOLLERR) */
+	void		 zeroCopied();
 
 	template<typename Type>
 	bool getOption(Exception& ex, int level, int option, Type& value) const {
@@ -239,8 +315,20 @@ private:
 
 	std::atomic<Int64>			_recvTime;
 	ByteRate					_recvByteRate;
+	std::atomic<UInt64>			_recvBatches;
+	std::atomic<UInt64>			_recvBatched;
+	UInt32						_recvSlotSize;
+	UInt32						_recvSlotDecay;
+	UInt32						_recvBatchCount; // datagrams requested by the next batch, adapted to the reception rate
 	std::atomic<Int64>			_sendTime;
 	ByteRate					_sendByteRate;
+	std::atomic<UInt64>			_sendBatches;
+	std::atomic<UInt64>			_sendBatched;
+	std::atomic<bool>			_sendBatch;
+	bool						_gso; // UDP_SEGMENT usable, false when the kernel refuses it
+	std::atomic<UInt32>			_zeroCopy; // minimum size of packet sent with MSG_ZEROCOPY, 0 = disabled
+	std::deque<Packet>			_zeroCopies; // packets waiting zero-copy completion, front has the id _zeroCopyId
+	UInt32						_zeroCopyId;
 
 //// Used by IOSocket /////////////////////
 	Decoder*					_pDecoder;
@@ -256,6 +344,10 @@ private:
 	std::atomic<UInt8>			_reading;
 	std::atomic<bool>			_sending;
 	const Handler*				_pHandler; // to diminue size of Action+Handle
+	std::atomic<IOSocket*>		_pIOSocket; // to request a flush in batched flush mode, or a sending in io_uring mode
+	weak<Socket>				_weakSocket;
+	std::atomic<bool>			_ring; // io_uring mode, the queue is sent by IOSocket (_sending = sending in progress)
+	bool						_shutdown; // sending part to shutdown after the sending in progress of io_uring mode (protected by _mutexSending)
 
 	bool						_opened;
 
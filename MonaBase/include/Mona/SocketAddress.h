@@ -110,6 +110,11 @@ struct SocketAddress : private IPAddress, virtual Object {
 	bool operator >  (const SocketAddress& address) const { return !operator<=(address); }
 	bool operator >= (const SocketAddress& address) const { return operator==(address) || operator>(address); }
 
+	/*!
+	Hash of host, scope and port, spread on all bits to key an open addressing table (see HashMap) */
+	UInt32 hash() const;
+	struct Hasher { UInt32 operator()(const SocketAddress& address) const { return address.hash(); } };
+
 	// Returns a wildcard IPv4 or IPv6 address (0.0.0.0) with port to 0
 	static const SocketAddress& Wildcard(IPAddress::Family family = IPAddress::IPv4);
 
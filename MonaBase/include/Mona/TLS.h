@@ -30,6 +30,14 @@ struct TLS : virtual Object {
 	static bool Create(Exception& ex, const std::string& cert, const std::string& key, shared<TLS>& pTLS, const SSL_METHOD* method = SSLv23_method()) { return Create(ex, cert.c_str(), key.c_str(), pTLS, method); }
 	static bool Create(Exception& ex, const char* cert, const char* key, shared<TLS>& pTLS, const SSL_METHOD* method = SSLv23_method());
 
+	/*!
+	Kernel TLS offload (kTLS), once the handshake done OpenSSL gives the symmetric keys to the kernel which encrypts the sendings,
+	TLS sockets can then send with system calls directly (gathering, sendfile). Requires OpenSSL >= 3.0 built with kTLS
+	and Linux tls module, falls back silently on user space encryption if the kernel or the cipher negotiated doesn't support it.
+	Ex::Unsupported if OpenSSL can't do it, to call before to create sockets */
+	bool setKernel(Exception& ex, bool enable);
+	bool getKernel() const;
+
 
 	struct Socket : virtual Object, Mona::Socket {
 		// http://fm4dd.com/openssl/sslconnect.htm
@@ -42,6 +50,9 @@ struct TLS : virtual Object {
 		const shared<TLS>	pTLS;
 
 		bool  isSecure() const { return pTLS ? true : false; }
+		/*!
+		True when kTLS encrypts the sendings (see TLS::setKernel) */
+		bool  isKernelSecure() const;
 
 		UInt32  available() const;
 	
@@ -96,6 +107,7 @@ struct TLS : virtual Object {
 
 		ssl_st*				_ssl;
 		mutable std::mutex	_mutex;
+		mutable volatile bool _kernelSecure;
 	};
 
 
@@ -22,11 +22,18 @@ details (or else see http://mozilla.org/MPL/2.0/).
 
 namespace Mona {
 
+/*!
+Pool of ThreadQueue, a runner queued with a thread (UInt16& thread) keeps this thread affinity to preserve the order of execution,
+whereas a runner queued without thread (nullptr) is stealable by an idle thread when its thread is busy (work-stealing) */
 struct ThreadPool : virtual Object {
 	ThreadPool(UInt16 threads = 0) : _current(0) { init(threads); }
 	ThreadPool(Thread::Priority priority, UInt16 threads = 0) : _current(0) { init(threads, priority); }
+	~ThreadPool();
 
 	UInt16	threads() const { return _size; }
+	/*!
+	Thread statistics (queue depth and steals), thread from 1 to threads() */
+	const ThreadQueue& thread(UInt16 thread) const { return *_threads[thread - 1]; }
 
 	UInt16	join();
 
@@ -38,17 +45,27 @@ struct ThreadPool : virtual Object {
 		++thread;
 	}
 	template<typename RunnerType>
-	void queue(std::nullptr_t, RunnerType&& pRunner) const { UInt16 thread(0); queue<RunnerType>(thread, std::forward<RunnerType>(pRunner)); }
+	void queue(std::nullptr_t, RunnerType&& pRunner) const {
+		UInt16 thread(_current++%_size);
+		_threads[thread]->queueStealable(std::forward<RunnerType>(pRunner));
+		wakeIdle(thread);
+	}
 	template <typename RunnerType, typename ...Args>
 	void queue(UInt16& thread, Args&&... args) const { queue(thread, std::make_shared<RunnerType>(std::forward<Args>(args)...)); }
 	template <typename RunnerType, typename ...Args>
-	void queue(std::nullptr_t, Args&&... args) const { UInt16 thread(0); queue<RunnerType>(thread, std::forward<Args>(args)...); }
+	void queue(std::nullptr_t, Args&&... args) const { queue(nullptr, std::make_shared<RunnerType>(std::forward<Args>(args)...)); }
 private:
 	void init(UInt16 threads, Thread::Priority priority = Thread::PRIORITY_NORMAL);
+	/*!
+	If thread is busy wake an idle thread to steal its runners */
+	void wakeIdle(UInt16 thread) const;
+	shared<Runner> steal(ThreadQueue& thief) const;
 
 	mutable std::vector<unique<ThreadQueue>>	_threads;
 	mutable std::atomic<UInt16>					_current;
 	UInt16										_size;
+
+	friend struct ThreadQueue;
 };
 
 
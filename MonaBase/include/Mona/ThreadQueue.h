@@ -19,34 +19,78 @@ details (or else see http://mozilla.org/MPL/2.0/).
 #include "Mona/Mona.h"
 #include "Mona/Thread.h"
 #include "Mona/Runner.h"
-#include <deque>
+#include "Mona/MPSCQueue.h"
 
 namespace Mona {
 
+struct ThreadPool;
 struct ThreadQueue : Thread, virtual Object {
-	ThreadQueue(Priority priority = PRIORITY_NORMAL) : Thread("ThreadQueue"), _priority(priority) {}
+	ThreadQueue(Priority priority = PRIORITY_NORMAL) : Thread("ThreadQueue"), _priority(priority), _pPool(NULL), _queueing(0), _steals(0), _busy(false) {}
 	virtual ~ThreadQueue() { stop(); }
 
 	static ThreadQueue*	Current() { return _PCurrent; }
 
+	/*!
+	Runners waiting in this thread */
+	UInt32	queueing() const { return _queueing; }
+	/*!
+	Runners stolen by this thread to other threads of its ThreadPool */
+	UInt64	steals() const { return _steals; }
+	/*!
+	Times where the thread has had to wait the end of a queueing */
+	UInt64	contentions() const { return _runners.contentions(); }
+	/*!
+	Wake-ups of the thread on queueing, queueings on a non-empty queue are coalesced */
+	UInt64	wakeUps() const { return _runners.wakeUps(); }
+
 	template<typename RunnerType>
 	void queue(RunnerType&& pRunner) {
 		DEBUG_ASSERT(pRunner); // more easy to debug that if it fails in the thread!
+		++_queueing;
+		if (!_runners.push(std::forward<RunnerType>(pRunner)))
+			return; // queue not empty, thread already waked up
+		// mutex just on empty to non-empty transition to protect start against the stop of run
 		std::lock_guard<std::mutex> lock(_mutex);
 		start(_priority);
-		_runners.emplace_back(std::forward<RunnerType>(pRunner));
 		wakeUp.set();
 	}
 	template <typename RunnerType, typename ...Args>
 	void queue(Args&&... args) { queue(std::make_shared<RunnerType>(std::forward<Args>(args)...)); }
 
 private:
+	/*!
+	Queue a runner without thread affinity, an idle thread of the ThreadPool can steal it */
+	template<typename RunnerType>
+	void queueStealable(RunnerType&& pRunner) {
+		DEBUG_ASSERT(pRunner);
+		std::lock_guard<std::mutex> lock(_mutex);
+		start(_priority);
+		_stealables.emplace_back(std::forward<RunnerType>(pRunner));
+		++_queueing;
+		wakeUp.set();
+	}
+	/*!
+	Give the oldest stealable runner to an other thread, returns null if nothing or if the queue is busy (no wait) */
+	shared<Runner> steal();
+	/*!
+	Wake up the thread to steal runners of the other threads */
+	void wake() { std::lock_guard<std::mutex> lock(_mutex); start(_priority); wakeUp.set(); }
+	bool idle() const { return !_busy && !_queueing; }
+
 	bool run(Exception& ex, const volatile bool& requestStop);
 
-	std::deque<shared<Runner>>			_runners;
+	MPSCQueue<shared<Runner>>			_runners;
+	std::deque<shared<Runner>>			_stealables;
 	std::mutex							_mutex;
 	static thread_local ThreadQueue*	_PCurrent;
 	Priority							_priority;
+
+	const ThreadPool*					_pPool;
+	std::atomic<UInt32>					_queueing;
+	std::atomic<UInt64>					_steals;
+	std::atomic<bool>					_busy;
+
+	friend struct ThreadPool;
 };
 
 
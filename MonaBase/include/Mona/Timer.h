@@ -19,14 +19,14 @@ details (or else see http://mozilla.org/MPL/2.0/).
 #include "Mona/Mona.h"
 #include "Mona/Time.h"
 #include "Mona/Exceptions.h"
-#include <set>
-#include <map>
 
 namespace Mona {
 
-
+/*!
+Hierarchical timing wheel with a resolution of 1 ms: 4 levels of 256 slots cover the UInt32 timeout range,
+set (insert, re-arm and cancel) is in O(1), timers of upper levels cascade to lower levels on the way */
 struct Timer : virtual Object {
-	Timer() : _count(0) {}
+	Timer();
 	~Timer();
 
 /*!
@@ -35,10 +35,10 @@ struct Timer : virtual Object {
 	struct OnTimer : std::function<UInt32(UInt32 delay)>, virtual Object {
 		NULLABLE(!_nextRaising)
 
-		OnTimer() : _nextRaising(0), count(0) {}
+		OnTimer() : _nextRaising(0), count(0), _pPrev(NULL), _pNext(NULL), _ppSlot(NULL) {}
 		// explicit to forbid to pass in "const OnTimer" parameter directly a lambda function
 		template<typename FunctionType>
-		explicit OnTimer(FunctionType&& function) : _nextRaising(0), count(0), std::function<UInt32(UInt32)>(std::move(function)) {}
+		explicit OnTimer(FunctionType&& function) : _nextRaising(0), count(0), _pPrev(NULL), _pNext(NULL), _ppSlot(NULL), std::function<UInt32(UInt32)>(std::move(function)) {}
 
 		~OnTimer() { if (_nextRaising) FATAL_ERROR("OnTimer function deleting while running"); }
 
@@ -56,7 +56,11 @@ struct Timer : virtual Object {
 
 		const UInt32 count;
 	private:
-		mutable Time	_nextRaising;
+		mutable Time				_nextRaising;
+		// intrusive double linked list of the slot
+		mutable const OnTimer*		_pPrev;
+		mutable const OnTimer*		_pNext;
+		mutable const OnTimer**		_ppSlot;
 
 		friend struct Timer;
 	};
@@ -73,11 +77,22 @@ struct Timer : virtual Object {
 	UInt32 raise();
 
 private:
-	void add(const OnTimer& onTimer,  UInt32 timeout) const;
-	bool remove(const OnTimer& onTimer, shared<std::set<const OnTimer*>>& pMove) const;
-
-	mutable	UInt32												_count;
-	mutable std::map<Int64, shared<std::set<const OnTimer*>>>	_timers;
+	enum {
+		SLOT_BITS = 8,
+		SLOTS = 1 << SLOT_BITS,
+		LEVELS = 4
+	};
+	void add(const OnTimer& onTimer) const;
+	void remove(const OnTimer& onTimer) const;
+	/*!
+	Next tick to process: expiration of level 0 or cascade of an upper level */
+	UInt64 next() const;
+	void   cascade(UInt8 level, UInt8 index);
+
+	mutable	UInt32					_count;
+	mutable UInt64					_tick; // next tick (ms) to process
+	mutable const OnTimer*			_slots[LEVELS][SLOTS];
+	mutable const OnTimer*			_pRaising; // slot detached during its raising
 };
 
 
@@ -0,0 +1,91 @@
+/*
+This file is a part of MonaSolutions Copyright 2017
+mathieu.poux[a]gmail.com
+jammetthomas[a]gmail.com
+
+This program is free software: you can redistribute it and/or
+modify it under the terms of the the Mozilla Public License v2.0.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+Mozilla Public License v. 2.0 received along this program for more
+details (or else see http://mozilla.org/MPL/2.0/).
+
+*/
+
+#pragma once
+
+#include "Mona/Mona.h"
+#include "Mona/FileLogger.h"
+#include "Mona/BinaryReader.h"
+#include "Mona/BinaryWriter.h"
+#include <unordered_map>
+
+namespace Mona {
+
+/*!
+Binary logger, writes logs and raw dumps in [0-rotation].trace files, without hexadecimal formatting.
+Format is "MTRC" + version (1 byte) followed by records which start with their type (1 byte):
+- TYPE_FILE: id (2 bytes), path (7bit size + string), source file definition preceding its first use in the file
+- TYPE_LOG: time (8 bytes), thread id (4 bytes), level (1 byte), source file id (2 bytes), line (4 bytes), message (7bit size + string)
+- TYPE_DUMP: time (8 bytes), thread id (4 bytes), header (7bit size + string), payload (7bit size + raw data)
+Numbers are in network order and time in milliseconds since epoch (emission time), TraceLogger::Reader decodes it (see MonaTrace tool).
+Records are buffered and written by batch on flush (see Logger::flush), or when the buffer exceeds BATCH_SIZE */
+struct TraceLogger : FileLogger, virtual Object {
+	enum Type : UInt8 {
+		TYPE_FILE = 0,
+		TYPE_LOG,
+		TYPE_DUMP
+	};
+	enum {
+		VERSION = 1,
+		BATCH_SIZE = 0xFFFF
+	};
+
+	TraceLogger(std::string&& dir, UInt32 sizeByFile = DEFAULT_SIZE_BY_FILE, UInt16 rotation = DEFAULT_ROTATION);
+	~TraceLogger();
+
+	bool binary() const { return true; }
+
+	bool log(LOG_LEVEL level, const Path& file, long line, const std::string& message);
+	bool dump(const std::string& header, const UInt8* data, UInt32 size);
+	bool flush();
+
+	struct Record : virtual Object {
+		Record() : type(TYPE_LOG), time(0), threadId(0), level(0), file(""), line(0), data(NULL), size(0) {}
+		Type			type; // TYPE_LOG or TYPE_DUMP
+		Int64			time;
+		UInt32			threadId;
+		LOG_LEVEL		level; // 0 for a dump
+		const char*		file; // empty for a dump
+		UInt32			line;
+		std::string		text; // message of the log, or header of the dump
+		const UInt8*	data; // payload of the dump
+		UInt32			size;
+	};
+	/*!
+	Trace decoder, data can be a concatenation of trace files */
+	struct Reader : virtual Object {
+		Reader(const UInt8* data, UInt32 size) : _reader(data, size), _corrupted(false) {}
+		/*!
+		Read the next log or dump, returns false on end or on corrupted data (see corrupted()) */
+		bool read(Record& record);
+		bool corrupted() const { return _corrupted; }
+	private:
+		bool readString(std::string& value);
+
+		BinaryReader					_reader;
+		std::map<UInt16, std::string>	_files;
+		bool							_corrupted;
+	};
+
+private:
+	void		onRotation() { _files.clear(); }
+	BinaryWriter& begin(BinaryWriter& writer);
+
+	Buffer									_buffer;
+	std::unordered_map<std::string, UInt16>	_files;
+};
+
+} // namespace Mona
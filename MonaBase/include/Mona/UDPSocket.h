@@ -67,8 +67,9 @@ struct UDPSocket : virtual Object {
 		Packet			_packet;
 		int				_flags;
 	};
-private:
+protected:
 	virtual Socket::Decoder* newDecoder() { return NULL; }
+private:
 
 	shared<Socket>		_pSocket;
 	bool				_subscribed;
@@ -0,0 +1,128 @@
+/*
+This file is a part of MonaSolutions Copyright 2017
+mathieu.poux[a]gmail.com
+jammetthomas[a]gmail.com
+
+This program is free software: you can redistribute it and/or
+modify it under the terms of the the Mozilla Public License v2.0.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+Mozilla Public License v. 2.0 received along this program for more
+details (or else see http://mozilla.org/MPL/2.0/).
+
+*/
+
+#pragma once
+
+#include "Mona/Mona.h"
+#include <atomic>
+#if !defined(_WIN32) && !defined(_BSD) && defined(__has_include)
+#if __has_include(<linux/io_uring.h>)
+	#include <linux/io_uring.h>
+	#include <sys/syscall.h>
+	#include <sys/uio.h>
+#if defined(IORING_POLL_ADD_MULTI) && defined(__NR_io_uring_setup)
+	#define URING_API // will define URing
+#if defined(IORING_RECVSEND_POLL_FIRST) && defined(__NR_io_uring_register)
+	#include <poll.h>
+	#include <sys/socket.h>
+	#define URING_NET_API // will define the socket operations of URing (headers >= 5.19, provided buffers)
+#endif
+#endif
+#endif
+#endif
+
+namespace Mona {
+
+#if defined(URING_API)
+/*!
+io_uring instance without liburing dependency (Linux >= 5.13),
+entries are queued by writev/nop/socket operations and submitted together by submit (one system call),
+SQ queueings and submissions must be protected by the caller, CQ must be consumed by one thread only */
+struct URing : virtual Object {
+	URing(UInt32 entries);
+	~URing() { close(); }
+
+	/*!
+	Ring file descriptor, < 0 if io_uring is unsupported */
+	operator int() const { return _fd; }
+
+	/*!
+	Queue a gathered write of iovs (must stay valid until completion), offset -1 writes at the current file position */
+	bool writev(int fd, const iovec* iovs, UInt32 count, UInt64 userData, Int64 offset = -1);
+	/*!
+	Queue a no operation, usefull to wake up the completion thread */
+	bool nop(UInt64 userData);
+#if defined(URING_NET_API)
+	/*!
+	Register a ring of count provided buffers (power of 2, Linux >= 5.19) where the receptions select their buffer, returns false if unsupported.
+	Each buffer is given by provide and must be given again after the use of its data */
+	bool setBuffers(UInt16 count);
+	void provide(UInt16 id, void* data, UInt32 size);
+	/*!
+	Queue a poll of fd on events, multishot (edge mode as EPOLLET) if multi */
+	bool poll(int fd, UInt32 events, UInt64 userData, bool multi = false);
+	/*!
+	Queue an accept of a connection, pAddress and pSize must stay valid until completion */
+	bool accept(int fd, sockaddr* pAddress, socklen_t* pSize, UInt64 userData);
+	/*!
+	Queue a reception in a provided buffer (see setBuffers), the completion flags give its id (IORING_CQE_BUFFER_SHIFT) */
+	bool recv(int fd, UInt64 userData);
+	/*!
+	Queue a gathered send, pMsg and its iovs must stay valid until completion */
+	bool sendmsg(int fd, const msghdr* pMsg, int flags, UInt64 userData);
+	/*!
+	Queue a timeout completed with -ETIME after duration, pDuration must stay valid until completion */
+	bool timeout(const __kernel_timespec* pDuration, UInt64 userData);
+	/*!
+	Queue the cancellation of the operation submitted with target, or of all the operations in flight if target is 0 */
+	bool cancel(UInt64 target, UInt64 userData);
+#endif
+	/*!
+	Submit the queued entries in one system call, returns the count accepted by the kernel or -1 on error (see errno).
+	Entries not accepted are withdrawn from the SQ, they will never be submitted by a next call */
+	int  submit();
+	/*!
+	Wait at least one completion, returns false on error */
+	bool wait();
+	/*!
+	Get the next completion, call next() after its treatment */
+	const io_uring_cqe* completion() const { UInt32 head(_cqHead->load(std::memory_order_relaxed)); return head == _cqTail->load(std::memory_order_acquire) ? NULL : &_cqes[head & _cqMask]; }
+	void next() { _cqHead->store(_cqHead->load(std::memory_order_relaxed) + 1, std::memory_order_release); }
+
+private:
+	/*!
+	Returns false if the SQ is full */
+	bool queue(const io_uring_sqe& sqe);
+	void close();
+
+	int						_fd;
+	void*					_pSQ;
+	size_t					_sqSize;
+	void*					_pCQ;
+	size_t					_cqSize;
+	void*					_pSQEs;
+	size_t					_sqesSize;
+	std::atomic<UInt32>*	_sqTail;
+	UInt32					_sqQueued; // tail including queued entries not submitted yet
+	UInt32					_sqEntries;
+	UInt32					_sqMask;
+	UInt32*					_sqArray;
+	std::atomic<UInt32>*	_cqHead;
+	std::atomic<UInt32>*	_cqTail;
+	UInt32					_cqMask;
+	io_uring_cqe*			_cqes;
+#if defined(URING_NET_API)
+	io_uring_buf_ring*		_pBuffers;
+	size_t					_buffersSize;
+	UInt16					_buffersMask;
+	UInt16					_buffersTail;
+#endif
+};
+#else
+struct URing : virtual Object {};
+#endif
+
+} // namespace Mona
@@ -23,6 +23,7 @@ details (or else see http://mozilla.org/MPL/2.0/).
 #define SetCurrentDirectory !chdir
 #endif
 #include "Mona/FileLogger.h"
+#include "Mona/TraceLogger.h"
 #include "Mona/Logs.h"
 
 using namespace std;
@@ -124,6 +125,9 @@ bool Application::init(int argc, const char* argv[]) {
 		setString("logs.directory", logDir);
 		setNumber("logs.rotation", rotation);
 		setNumber("logs.maxSize", sizeByFile);
+		// binary logs, dumps are then reserved to it (see TraceLogger)
+		if (getBoolean<false>("logs.trace"))
+			Logs::AddLogger<TraceLogger>("trace", String(logDir), sizeByFile, rotation);
 		// Set Logger after opening _logStream!
 		if (!Logs::AddLogger<FileLogger>(String("file!", name(), " already running?"), move(logDir), sizeByFile, rotation))
 			FATAL_ERROR(name(), " initLogs can't override file logger");
@@ -227,12 +231,18 @@ void Application::onParamChange(const string& key, const string* pValue) {
 		if (pValue)
 			String::ToNumber(*pValue, level);
 		Logs::SetLevel(level);
+	} else if (String::ICompare(key, "logs.async") == 0) {
+		UInt32 capacity(0);
+		if (pValue)
+			String::ToNumber(*pValue, capacity);
+		Logs::SetAsync(capacity);
 	}
 		
 	Parameters::onParamChange(key, pValue);
 }
 void Application::onParamClear() {
 	Logs::SetLevel(getNumber<UInt8, LOG_DEFAULT>("arguments.log"));
+	Logs::SetAsync(0);
 	Net::ResetRecvBufferSize();
 	Net::ResetSendBufferSize();
 	Parameters::onParamClear();
@@ -244,12 +254,16 @@ int Application::run(int argc, const char* argv[]) {
 #endif
 		if (!init(argc, argv))
 			return EXIT_OK;
-		return main();
+		int result = main();
+		Logs::SetAsync(0); // last drain of asynchronous logs
+		return result;
 #if !defined(_DEBUG)
 	} catch (exception& ex) {
+		Logs::SetAsync(0); // drain before to keep logs order
 		FATAL(ex.what());
 		return EXIT_SOFTWARE;
 	} catch (...) {
+		Logs::SetAsync(0);
 		FATAL("Unknown error");
 		return EXIT_SOFTWARE;
 	}
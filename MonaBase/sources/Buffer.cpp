@@ -22,7 +22,32 @@ using namespace std;
 namespace Mona {
 
 atomic_flag Buffer::Allocator::_Mutex = ATOMIC_FLAG_INIT;
-unique<Buffer::Allocator>	Buffer::Allocator::_PAllocator(SET);
+shared<Buffer::Allocator>	Buffer::Allocator::_PAllocator(SET);
+atomic<UInt32>				Buffer::Allocator::_Generation(0);
+const UInt8*				Buffer::Allocator::_ArenaBegin(NULL);
+const UInt8*				Buffer::Allocator::_ArenaEnd(NULL);
+void						(*Buffer::Allocator::_ArenaRelease)(UInt8* buffer)(NULL);
+
+static thread_local bool _Exited(false); // trivial type, still valid after the thread_local destructions
+
+Buffer::Allocator* Buffer::Allocator::Current() {
+	// thread reference to avoid the lock on every allocation, keeps alive the allocator during its using
+	static thread_local struct Reference : virtual Object {
+		Reference() : generation(0) {}
+		~Reference() { _Exited = true; }
+		shared<Allocator>	pAllocator;
+		UInt32				generation;
+	} Reference;
+	if (_Exited)
+		return NULL; // thread is exiting
+	if (!Reference.pAllocator || Reference.generation != _Generation.load(memory_order_acquire)) {
+		Lock();
+		Reference.pAllocator = _PAllocator;
+		Reference.generation = _Generation;
+		Unlock();
+	}
+	return Reference.pAllocator.get();
+}
 
 UInt32 Buffer::Allocator::ComputeCapacity(UInt32 size) {
 	if (size <= 16) // at minimum allocate 16 bytes!
@@ -38,18 +63,31 @@ UInt32 Buffer::Allocator::ComputeCapacity(UInt32 size) {
 }
 UInt8* Buffer::Allocator::Alloc(UInt32& size) {
 	size = ComputeCapacity(size);
-	if (size>0x80000000 || !TryLock())
+	if (size>0x80000000)
 		return new UInt8[size];
+	Allocator* pAllocator(Current());
+	if (pAllocator)
+		return pAllocator->alloc(size);
+	Lock();
 	UInt8* buffer = _PAllocator->alloc(size);
 	Unlock();
 	return buffer;
 }
 void Buffer::Allocator::Free(UInt8* buffer, UInt32 size) {
-	if ((!size || (size & (size - 1))) || !TryLock())  // check than we have a size create with Alloc (capacity log2) + TryLock working!
+	if (!size || (size & (size - 1)))  // check than we have a size create with Alloc (capacity log2)
 		return delete[] buffer;
-	_PAllocator->free(buffer, size);
+	Allocator* pAllocator(Current());
+	if (pAllocator)
+		return Free(*pAllocator, buffer, size);
+	Lock();
+	Free(*_PAllocator, buffer, size);
 	Unlock();
 }
+void Buffer::Allocator::Free(Allocator& allocator, UInt8* buffer, UInt32 size) {
+	if (buffer >= _ArenaBegin && buffer < _ArenaEnd && !allocator.arena())
+		return _ArenaRelease(buffer); // arena buffer living after the replacement of its allocator
+	allocator.free(buffer, size);
+}
 
 static UInt8 _Empty;
 
@@ -15,6 +15,10 @@ details (or else see http://mozilla.org/MPL/2.0/).
 */
 
 #include "Mona/BufferPool.h"
+#include "Mona/Logs.h"
+#if !defined(_WIN32)
+#include <sys/mman.h>
+#endif
 
 
 using namespace std;
@@ -22,53 +26,371 @@ using namespace std;
 
 namespace Mona {
 
-UInt8* BufferPool::Buffers::pop() {
-	if (empty())
-		return NULL;
-	UInt8* buffer = back();
-	pop_back();
-	if (size() < _minSize)
-		_minSize = size();
-	return buffer;
-}
-void BufferPool::Buffers::push(UInt8* buffer) {
-	emplace_back(buffer);
-	if (size() > _maxSize)
-		_maxSize = size();
-}
-void BufferPool::Buffers::manage(vector<UInt8*>& gc) {
-	// pickUp
-	UInt32 position = gc.size();
-	gc.resize(position + _minSize);
-	memcpy(gc.data() + position, data() + size() - _minSize, _minSize * sizeof(UInt8*));
-	// reserve max capacity + remove erasing buffer + reset _minSize/_maxSize
-	_minSize = size() - _minSize;
-	resize(_maxSize);
-	shrink_to_fit();
-	resize(_minSize);
-	_maxSize = 0;
-}
-
-bool BufferPool::run(Exception& ex, const volatile bool& requestStop) {
-	UInt16 timeout = 10000;
-	while (!requestStop) {
-		if (timeout && wakeUp.wait(timeout)) // wait()==true means requestStop=true because there is no other wakeUp.set elsewhere
-			return true;
-		Time time;
-		for (Buffers& buffers : _buffers) {
-			vector<UInt8*> gc;
-			Lock();
-			buffers.manage(gc); // garbage collector!
-			Unlock();
-			for (UInt8* buffer : gc)
-				delete[] buffer;
+static thread_local bool _Exited(false); // trivial type, still valid after the thread_local destructions
+
+struct BufferPool::Arena : virtual Object {
+	enum {
+		SLAB_SIZE = 0x200000, // 2MB
+		MIN_INDEX = 12, // 64KB
+		MAX_INDEX = 17 // 2MB
+	};
+	static Arena* Get() { return _PArena.load(memory_order_acquire); }
+	static void Create(UInt32 slabs) {
+		static mutex Mutex;
+		lock_guard<mutex> lock(Mutex);
+		Arena* pArena(Get());
+		if (pArena) {
+			if (pArena->slabs != slabs)
+				WARN("BufferPool arena already created with ", pArena->slabs, " huge pages");
+			return;
+		}
+		pArena = new Arena(slabs);
+		if (!pArena->_pBegin) {
+			WARN("BufferPool arena of ", slabs, " huge pages allocation failed, ", strerror(errno));
+			delete pArena;
+			return;
+		}
+		SetArena(pArena->_pBegin, pArena->_pEnd, [](UInt8* buffer) { Get()->free(buffer); }); // for the allocators which replace the pool
+		_PArena.store(pArena, memory_order_release); // never deleted, buffers can be freed until the end of the process
+	}
+
+	bool owns(const UInt8* buffer) const { return buffer >= _pBegin && buffer < _pEnd; }
+
+	UInt8* alloc(UInt8 index) {
+		Class& arenaClass(_classes[index - MIN_INDEX]);
+		lock_guard<mutex> lock(arenaClass.mutex);
+		if (arenaClass.buffers.empty()) {
+			// carve a new slab
+			UInt32 slab(_carved);
+			do {
+				if (slab >= slabs) {
+					if (!arenaClass.full) {
+						arenaClass.full = true;
+						WARN("BufferPool arena full (", slabs, " huge pages), increase buffer.hugepages parameter");
+					}
+					return NULL;
+				}
+			} while (!_carved.compare_exchange_weak(slab, slab + 1));
+			_slabClasses[slab] = index;
+			++arenaClass.slabs;
+			UInt32 capacity(16 << index);
+			UInt8* buffer(_pBegin + size_t(slab) * SLAB_SIZE);
+			for (UInt32 i = 0; i < SLAB_SIZE; i += capacity)
+				arenaClass.buffers.emplace_back(buffer + i);
+		}
+		UInt8* buffer(arenaClass.buffers.back());
+		arenaClass.buffers.pop_back();
+		++arenaClass.used;
+		return buffer;
+	}
+	void free(UInt8* buffer) {
+		Class& arenaClass(_classes[_slabClasses[(buffer - _pBegin) / SLAB_SIZE] - MIN_INDEX]);
+		lock_guard<mutex> lock(arenaClass.mutex);
+		arenaClass.buffers.emplace_back(buffer);
+		--arenaClass.used;
+	}
+
+	UInt32 carved() const { return _carved; }
+	UInt32 slabsOf(UInt8 index) const { return index < MIN_INDEX || index > MAX_INDEX ? 0 : _classes[index - MIN_INDEX].slabs.load(); }
+	UInt32 usedOf(UInt8 index) const { return index < MIN_INDEX || index > MAX_INDEX ? 0 : _classes[index - MIN_INDEX].used.load(); }
+
+	const UInt32	slabs;
+	bool			hugeTLB;
+private:
+	Arena(UInt32 slabs) : slabs(slabs), hugeTLB(false), _pBegin(NULL), _pEnd(NULL), _carved(0), _slabClasses(slabs) {
+#if !defined(_WIN32)
+		size_t size(size_t(slabs) * SLAB_SIZE);
+		void* pMemory(MAP_FAILED);
+#if defined(MAP_HUGETLB)
+		// reserved huge pages (vm.nr_hugepages), pre-faulted
+		pMemory = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB | MAP_POPULATE, -1, 0);
+		hugeTLB = pMemory != MAP_FAILED;
+#endif
+		if (!hugeTLB) {
+			// transparent huge pages, map more to align on 2MB
+			if ((pMemory = mmap(NULL, size + SLAB_SIZE, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0)) == MAP_FAILED)
+				return;
+			UInt8* pAligned((UInt8*)((uintptr_t(pMemory) + SLAB_SIZE - 1) & ~uintptr_t(SLAB_SIZE - 1)));
+			if (pAligned > pMemory)
+				munmap(pMemory, pAligned - (UInt8*)pMemory);
+			if (pAligned < (UInt8*)pMemory + SLAB_SIZE)
+				munmap(pAligned + size, (UInt8*)pMemory + SLAB_SIZE - pAligned);
+#if defined(MADV_HUGEPAGE)
+			madvise(pAligned, size, MADV_HUGEPAGE);
+#endif
+			for (size_t i = 0; i < size; i += 0x1000)
+				pAligned[i] = 0; // pre-fault
+			pMemory = pAligned;
 		}
-		timeout = (UInt16)max(10000 - time.elapsed(), 0);
+		_pEnd = (_pBegin = (UInt8*)pMemory) + size;
+#else
+		errno = ENOTSUP;
+#endif
+	}
+
+	struct Class : virtual Object {
+		Class() : slabs(0), used(0), full(false) {}
+		std::mutex			mutex;
+		vector<UInt8*>		buffers;
+		atomic<UInt32>		slabs;
+		atomic<UInt32>		used;
+		bool				full;
+	};
+	UInt8*					_pBegin;
+	UInt8*					_pEnd;
+	atomic<UInt32>			_carved;
+	vector<UInt8>			_slabClasses;
+	Class					_classes[MAX_INDEX - MIN_INDEX + 1];
+
+	static atomic<Arena*>	_PArena;
+};
+atomic<BufferPool::Arena*> BufferPool::Arena::_PArena(NULL);
+
+BufferPool::BufferPool(UInt64 maxMemory, UInt32 hugePages) : _pDepot(SET, maxMemory) {
+	if (hugePages)
+		Arena::Create(hugePages);
+}
+
+UInt32 BufferPool::arenaSlabs() const {
+	Arena* pArena(Arena::Get());
+	return pArena ? pArena->slabs : 0;
+}
+UInt32 BufferPool::arenaOccupancy() const {
+	Arena* pArena(Arena::Get());
+	return pArena ? min(pArena->carved(), pArena->slabs) : 0;
+}
+UInt32 BufferPool::arenaSlabs(UInt32 capacity) const {
+	Arena* pArena(Arena::Get());
+	return pArena ? pArena->slabsOf(ComputeIndex(capacity)) : 0;
+}
+UInt32 BufferPool::arenaBuffers(UInt32 capacity) const {
+	Arena* pArena(Arena::Get());
+	return pArena ? pArena->usedOf(ComputeIndex(capacity)) : 0;
+}
+bool BufferPool::arenaHugeTLB() const {
+	Arena* pArena(Arena::Get());
+	return pArena && pArena->hugeTLB;
+}
+
+void BufferPool::manage() {
+	for (UInt8 index = 0; index < 28; ++index) {
+		Depot::Class& depotClass(_pDepot->classes[index]);
+		lock_guard<mutex> lock(depotClass.mutex);
+		depotClass.manage(16 << index, *_pDepot);
+	}
+}
+
+UInt8* BufferPool::Allocate(UInt8 index, UInt32 capacity) {
+	Arena* pArena(Arena::Get());
+	if (pArena && index >= Arena::MIN_INDEX && index <= Arena::MAX_INDEX) {
+		UInt8* buffer(pArena->alloc(index));
+		if (buffer)
+			return buffer;
 	}
+	return new UInt8[capacity];
+}
+void BufferPool::Release(UInt8* buffer) {
+	Arena* pArena(Arena::Get());
+	if (pArena && pArena->owns(buffer))
+		return pArena->free(buffer);
+	delete[] buffer;
+}
+
+BufferPool::Depot::Class::~Class() {
+	for (UInt8* buffer : _buffers)
+		Release(buffer);
+}
+
+// magazine of 256KB at maximum, 32 buffers for small classes until 1 buffer for classes >= 256KB
+static UInt8 MagazineSize(UInt8 index) { return UInt8(max(min(0x4000 >> index, 32), 1)); }
+// refill and return by half magazine
+static UInt8 BatchSize(UInt8 index) { return UInt8(max(MagazineSize(index) >> 1, 1)); }
+
+struct BufferPool::Magazines : virtual Object {
+	Magazines() { memset(magazines, 0, sizeof(magazines)); }
+	~Magazines() {
+		reset();
+		_Exited = true;
+	}
+
+	struct Magazine {
+		UInt8*	buffers[32];
+		UInt8	size;
+		UInt8	published; // size already counted in the memory of the depot
+		UInt32	hits;
+		UInt32	misses;
+	};
+	/*!
+	Publish stats of the magazine in its depot class (depot class mutex has to be locked) */
+	void publish(UInt8 index, UInt32 capacity) {
+		Magazine& magazine(magazines[index]);
+		Depot::Class& depotClass(pDepot->classes[index]);
+		depotClass.hits += magazine.hits;
+		depotClass.misses += magazine.misses;
+		magazine.hits = magazine.misses = 0;
+		UInt64 delta((Int64(magazine.size) - magazine.published) * capacity);
+		depotClass.memory += delta;
+		pDepot->memory += delta;
+		magazine.published = magazine.size;
+	}
+	/*!
+	Return all the buffers to the current depot and change of depot */
+	void reset(const shared<Depot>& pDepot = nullptr) {
+		if (this->pDepot) {
+			for (UInt8 index = 0; index < 28; ++index) {
+				Magazine& magazine(magazines[index]);
+				UInt32 capacity(16 << index);
+				UInt8 count(magazine.size), pushed;
+				{
+					lock_guard<mutex> lock(this->pDepot->classes[index].mutex);
+					magazine.size = 0;
+					publish(index, capacity); // before push to not count twice the memory moved
+					pushed = this->pDepot->classes[index].push(magazine.buffers, count, capacity, *this->pDepot);
+				}
+				while (pushed < count) // exceeds maxMemory
+					Release(magazine.buffers[pushed++]);
+			}
+		}
+		memset(magazines, 0, sizeof(magazines));
+		this->pDepot = pDepot;
+	}
+
+	shared<Depot>	pDepot;
+	Magazine		magazines[28];
+};
+
+BufferPool::Magazines* BufferPool::magazines() {
+	if (_Exited)
+		return NULL; // thread is exiting
+	static thread_local Magazines Magazines;
+	if (Magazines.pDepot != _pDepot)
+		Magazines.reset(_pDepot); // new pool
+	return &Magazines;
+}
+
+UInt8* BufferPool::alloc(UInt32& capacity) {
+	UInt8 index(ComputeIndex(capacity));
+	Depot::Class& depotClass(_pDepot->classes[index]);
+	Magazines* pMagazines(magazines());
+	if (!pMagazines) {
+		UInt8* buffer;
+		lock_guard<mutex> lock(depotClass.mutex);
+		if (depotClass.pop(&buffer, 1, capacity, *_pDepot)) {
+			++depotClass.hits;
+			return buffer;
+		}
+		++depotClass.misses;
+		return Allocate(index, capacity);
+	}
+	Magazines::Magazine& magazine(pMagazines->magazines[index]);
+	if (!magazine.size) {
+		// refill
+		lock_guard<mutex> lock(depotClass.mutex);
+		magazine.size = depotClass.pop(magazine.buffers, BatchSize(index), capacity, *_pDepot);
+		pMagazines->publish(index, capacity);
+	}
+	if (magazine.size) {
+		++magazine.hits;
+		if (_pDepot->maxMemory) {
+			// exact accounting to keep maxMemory
+			depotClass.memory -= capacity;
+			_pDepot->memory -= capacity;
+			--magazine.published;
+		}
+		return magazine.buffers[--magazine.size];
+	}
+	++magazine.misses;
+	return Allocate(index, capacity);
+}
+
+void BufferPool::free(UInt8* buffer, UInt32 capacity) {
+	UInt8 index(ComputeIndex(capacity));
+	Depot::Class& depotClass(_pDepot->classes[index]);
+	Magazines* pMagazines(magazines());
+	if (!pMagazines) {
+		bool pushed;
+		{
+			lock_guard<mutex> lock(depotClass.mutex);
+			pushed = depotClass.push(&buffer, 1, capacity, *_pDepot) > 0;
+		}
+		if (!pushed)
+			Release(buffer);
+		return;
+	}
+	Magazines::Magazine& magazine(pMagazines->magazines[index]);
+	if (magazine.size == MagazineSize(index)) {
+		// return
+		UInt8 count(BatchSize(index)), pushed;
+		UInt8** buffers(magazine.buffers + (magazine.size -= count));
+		{
+			lock_guard<mutex> lock(depotClass.mutex);
+			pMagazines->publish(index, capacity); // before push to not count twice the memory moved
+			pushed = depotClass.push(buffers, count, capacity, *_pDepot);
+		}
+		while (pushed < count) // exceeds maxMemory
+			Release(buffers[pushed++]);
+	}
+	if (_pDepot->maxMemory) {
+		// exact accounting to keep maxMemory
+		if (!_pDepot->keep(depotClass, capacity))
+			return Release(buffer);
+		++magazine.published;
+	}
+	magazine.buffers[magazine.size++] = buffer;
+}
+
+bool BufferPool::Depot::keep(Class& depotClass, UInt32 capacity) {
+	if ((memory.fetch_add(capacity) + capacity) > maxMemory) {
+		memory -= capacity;
+		return false;
+	}
+	depotClass.memory += capacity;
 	return true;
 }
 
-UInt8 BufferPool::computeIndex(UInt32 capacity) {
+UInt8 BufferPool::Depot::Class::pop(UInt8** buffers, UInt8 count, UInt32 capacity, Depot& depot) {
+	manage(capacity, depot);
+	if (count > _buffers.size())
+		count = UInt8(_buffers.size());
+	if (!count)
+		return 0;
+	memcpy(buffers, _buffers.data() + _buffers.size() - count, count * sizeof(UInt8*));
+	_buffers.resize(_buffers.size() - count);
+	if (_buffers.size() < _minSize)
+		_minSize = _buffers.size();
+	memory -= UInt64(count) * capacity;
+	depot.memory -= UInt64(count) * capacity;
+	return count;
+}
+
+UInt8 BufferPool::Depot::Class::push(UInt8** buffers, UInt8 count, UInt32 capacity, Depot& depot) {
+	manage(capacity, depot);
+	if (depot.maxMemory) {
+		// keep maxMemory
+		UInt64 available(depot.memory < depot.maxMemory ? (depot.maxMemory - depot.memory) : 0);
+		if (UInt64(count) * capacity > available)
+			count = UInt8(available / capacity);
+	}
+	_buffers.insert(_buffers.end(), buffers, buffers + count);
+	memory += UInt64(count) * capacity;
+	depot.memory += UInt64(count) * capacity;
+	return count;
+}
+
+void BufferPool::Depot::Class::manage(UInt32 capacity, Depot& depot) {
+	if (!_managed.isElapsed(10000))
+		return;
+	// garbage collector, release buffers unused since 10 seconds
+	for (UInt32 i = 0; i < _minSize; ++i)
+		Release(_buffers[i]);
+	_buffers.erase(_buffers.begin(), _buffers.begin() + _minSize);
+	memory -= UInt64(_minSize) * capacity;
+	depot.memory -= UInt64(_minSize) * capacity;
+	_minSize = _buffers.size();
+	_managed.update();
+}
+
+UInt8 BufferPool::ComputeIndex(UInt32 capacity) {
 	--capacity;
 	// compute index
 	capacity = (capacity << 3) - capacity;    // Multiply by 7.
@@ -15,6 +15,7 @@ details (or else see http://mozilla.org/MPL/2.0/).
 */
 
 #include "Mona/File.h"
+#include "Mona/Logs.h"
 #include <sys/types.h>
 #include <sys/stat.h>
 #if !defined(_WIN32)
@@ -22,12 +23,16 @@ details (or else see http://mozilla.org/MPL/2.0/).
 #include <sys/file.h>
 #define INVALID_HANDLE_VALUE -1
 #include <unistd.h>
+#include <sys/uio.h>
 #if defined(_BSD) && !defined(lseek64) // not defined on 64 bit systems
 	#define lseek64 lseek
 	#define off64_t off_t
 #endif
 #endif
-
+#if defined(O_DIRECT)
+	#define DIRECT_ALIGN 4096 // block alignment accepted by all file systems
+	#define DIRECT_SIZE	 0x40000 // size of written blocks in direct mode (multiple of DIRECT_ALIGN)
+#endif
 
 
 
@@ -35,9 +40,50 @@ using namespace std;
 
 namespace Mona {
 
+#if !defined(_WIN32)
+/*!
+Write all the iovs, retries the partial writings (signal interruption, disk space released meanwhile...),
+returns bytes written, less than expected on error with errno set */
+static size_t WriteV(long handle, iovec* iovs, int count) {
+	size_t written(0);
+	ssize_t result(0);
+	for (;;) {
+		// skip the written iovs
+		while (count && size_t(result) >= iovs->iov_len) {
+			result -= iovs->iov_len;
+			++iovs;
+			--count;
+		}
+		if (!count)
+			return written;
+		iovs->iov_base = (UInt8*)iovs->iov_base + result;
+		iovs->iov_len -= result;
+		result = ::writev(handle, iovs, count);
+		if (result < 0) {
+			if (errno != EINTR)
+				return written;
+			result = 0;
+			continue;
+		}
+		if (!result) {
+			errno = ENOSPC;
+			return written;
+		}
+		written += result;
+	}
+}
+static void WriteError(Exception& ex, const Path& path, UInt64 size) {
+	if (errno == ENOSPC || errno == EDQUOT)
+		ex.set<Ex::System::File>("No more disk space to write ", path, " (size=", size, ")");
+	else
+		ex.set<Ex::System::File>("Impossible to write ", path, " (size=", size, "), ", strerror(errno));
+}
+#endif
+
 File::File(const Path& path, Mode mode) : _flushing(0), _loaded(false), _pDecoder(NULL),
 	_written(0), _readen(0), _path(path), mode(mode), _decodingTrack(0),
-	_queueing(0), _ioTrack(0), _handle(INVALID_HANDLE_VALUE), _externDecoder(false) {
+	_queueing(0), _ioTrack(0), _handle(INVALID_HANDLE_VALUE), _externDecoder(false),
+	_direct(false), _pStaging(NULL), _staged(0), _pending(0), _pWritings(NULL), _ringWriting(false) {
 }
 
 File::~File() {
@@ -48,6 +94,9 @@ File::~File() {
 	// No CPU expensive
 	if (_handle == INVALID_HANDLE_VALUE)
 		return;
+	Exception ex;
+	if (!endDirect(ex)) // last block not written before by IOFile::unsubscribe (synchronous usage)
+		ERROR(ex);
 #if defined(_WIN32)
 	CloseHandle((HANDLE)_handle);
 #else
@@ -77,6 +126,9 @@ bool File::load(Exception& ex) {
 		return false;
 	}
 	// file READ, WRITE or APPEND
+#if !defined(O_DIRECT)
+	_direct = false; // unsupported
+#endif
 #if defined(_WIN32)
 	wchar_t wFile[PATH_MAX];
 	MultiByteToWideChar(CP_UTF8, 0, _path.c_str(), -1, wFile, sizeof(wFile));
@@ -121,7 +173,20 @@ bool File::load(Exception& ex) {
 			flags |= O_APPEND;
 	} else
 		flags = O_RDONLY;
+#if defined(O_DIRECT)
+	if (_direct && mode)
+		flags |= O_DIRECT;
 	_handle = ::open(_path.c_str(), flags, S_IRWXU);
+	if (_handle == INVALID_HANDLE_VALUE && (flags & O_DIRECT) && errno == EINVAL) {
+		// file system without O_DIRECT support (tmpfs for example)
+		flags &= ~O_DIRECT;
+		_handle = ::open(_path.c_str(), flags, S_IRWXU);
+	}
+	if (!(flags & O_DIRECT))
+		_direct = false;
+#else
+	_handle = ::open(_path.c_str(), flags, S_IRWXU);
+#endif
 	while (_handle != INVALID_HANDLE_VALUE) {
 		if (mode && flock(_handle, LOCK_EX | LOCK_NB) != 0) { // exclusive write!
 			// fail to lock!
@@ -135,6 +200,19 @@ bool File::load(Exception& ex) {
 		struct stat status;
 		::fstat(_handle, &status);
 		_path._pImpl->setAttributes(status.st_mode&S_IFDIR ? 0 : (UInt64)status.st_size, status.st_atime * 1000ll, status.st_mtime * 1000ll);
+#if defined(O_DIRECT)
+		if (_direct) {
+			// APPEND requires an aligned size, and is replaced by a positioning at the end to allow the partial block writing of endDirect
+			if ((mode == MODE_APPEND && (status.st_size % DIRECT_ALIGN)) || posix_memalign((void**)&_pStaging, DIRECT_ALIGN, DIRECT_SIZE)) {
+				_pStaging = NULL;
+				_direct = false;
+				fcntl(_handle, F_SETFL, fcntl(_handle, F_GETFL) & ~O_DIRECT);
+			} else if (mode == MODE_APPEND) {
+				fcntl(_handle, F_SETFL, fcntl(_handle, F_GETFL) & ~O_APPEND);
+				lseek64(_handle, 0, SEEK_END);
+			}
+		}
+#endif
 		_loaded = true;
 		return true;
 	}
@@ -185,6 +263,8 @@ UInt64 File::size(bool refresh) const {
 void File::reset(UInt64 position) {
 	if(!_loaded)
 		return;
+	Exception ex;
+	endDirect(ex); // direct mode requires an aligned position
 	_readen = position;
 #if defined(_WIN32)
 	LARGE_INTEGER offset;
@@ -235,13 +315,12 @@ bool File::write(Exception& ex, const void* data, UInt32 size) {
 	}
 	if (!size)
 		return true; // nothing todo!
+	if (_pStaging)
+		return writeDirect(ex, BIN data, size, size);
 #if defined(_WIN32)
 	DWORD written;
 	if (!WriteFile((HANDLE)_handle, data, size, &written, NULL))
 		written = 0;
-#else
-	ssize_t written = ::write(_handle, data, size);
-#endif
 	if (written <= 0) {
 		ex.set<Ex::System::File>("Impossible to write ", _path, " (size=", size, ")");
 		return false;
@@ -251,6 +330,113 @@ bool File::write(Exception& ex, const void* data, UInt32 size) {
 		ex.set<Ex::System::File>("No more disk space to write ", _path, " (size=", size, ")");
 		return false;
 	}
+#else
+	iovec iov;
+	iov.iov_base = (void*)data;
+	iov.iov_len = size;
+	size_t written = WriteV(_handle, &iov, 1);
+	_written += written;
+	if (written < size) {
+		WriteError(ex, _path, size);
+		return false;
+	}
+#endif
+	return true;
+}
+
+bool File::write(Exception& ex, const deque<Packet>& packets) {
+	UInt64 size(0);
+	for (const Packet& packet : packets)
+		size += packet.size();
+	if (_path.isFolder()) {
+		if (size)
+			ex.set<Ex::Intern>("Cannot write data to a ", _path, " folder");
+		return FileSystem::CreateDirectory(ex, _path);
+	}
+	if (!load(ex))
+		return false;
+	if (!mode || mode > MODE_APPEND) {
+		ex.set<Ex::Permission>(_path, " write unauthorized in reading or deletion mode");
+		return false;
+	}
+	if (_pStaging) {
+		for (const Packet& packet : packets) {
+			if (!writeDirect(ex, packet.data(), packet.size(), size))
+				return false;
+		}
+		return true;
+	}
+#if defined(_WIN32)
+	for (const Packet& packet : packets) {
+		if (!write(ex, packet.data(), packet.size()))
+			return false;
+	}
+#else
+	iovec iovs[64];
+	auto it = packets.begin();
+	while (it != packets.end()) {
+		int count(0);
+		size_t expected(0);
+		for (; count < 64 && it != packets.end(); ++it) {
+			if (!*it)
+				continue;
+			iovs[count].iov_base = (void*)it->data();
+			expected += (iovs[count++].iov_len = it->size());
+		}
+		if (!count)
+			break;
+		size_t written = WriteV(_handle, iovs, count);
+		_written += written;
+		if (written < expected) {
+			WriteError(ex, _path, size);
+			return false;
+		}
+	}
+#endif
+	return true;
+}
+
+bool File::writeDirect(Exception& ex, const UInt8* data, UInt32 size, UInt64 total) {
+#if defined(O_DIRECT)
+	while (size) {
+		UInt32 copied(min(size, DIRECT_SIZE - _staged));
+		memcpy(_pStaging + _staged, data, copied);
+		data += copied;
+		size -= copied;
+		_written += copied;
+		if ((_staged += copied) < DIRECT_SIZE)
+			continue;
+		_staged = 0;
+		iovec iov;
+		iov.iov_base = _pStaging;
+		iov.iov_len = DIRECT_SIZE;
+		if (WriteV(_handle, &iov, 1) < DIRECT_SIZE) {
+			WriteError(ex, _path, total);
+			return false;
+		}
+	}
+#endif
+	return true;
+}
+
+bool File::endDirect(Exception& ex) {
+#if defined(O_DIRECT)
+	if (!_pStaging)
+		return true;
+	// write the last incomplete block with system cache, O_DIRECT requires an aligned size
+	fcntl(_handle, F_SETFL, fcntl(_handle, F_GETFL) & ~O_DIRECT);
+	iovec iov;
+	iov.iov_base = _pStaging;
+	iov.iov_len = _staged;
+	bool success(WriteV(_handle, &iov, 1) == _staged);
+	if (!success)
+		WriteError(ex, _path, _staged);
+	free(_pStaging);
+	_pStaging = NULL;
+	_direct = false;
+	_staged = 0;
+	return success;
+#endif
 	return true;
 }
 
@@ -264,6 +450,7 @@ bool File::erase(Exception& ex) {
 	if (_loaded) {
 		_readen = 0;
 		_written = 0;
+		_staged = 0; // useless to write it
 	}
 	_path._pImpl->setAttributes(0, 0, 0); // update attributes (no exists!)
 	return true;
@@ -22,15 +22,18 @@ using namespace std;
 
 namespace Mona {
 
-FileLogger::FileLogger(string&& dir, UInt32 sizeByFile, UInt16 rotation) : _sizeByFile(sizeByFile), _rotation(rotation),
-	_pFile(SET, Path(MAKE_FOLDER(dir), "0.log"), File::MODE_APPEND) {
+FileLogger::FileLogger(string&& dir, UInt32 sizeByFile, UInt16 rotation) : FileLogger(move(dir), sizeByFile, rotation, "log") {
+}
+
+FileLogger::FileLogger(string&& dir, UInt32 sizeByFile, UInt16 rotation, const char* extension) : _sizeByFile(sizeByFile), _rotation(rotation), _extension(extension),
+	_pFile(SET, Path(MAKE_FOLDER(dir), "0.", extension), File::MODE_APPEND) {
 	_written = range<UInt32>(_pFile->size());
 }
 
 bool FileLogger::log(LOG_LEVEL level, const Path& file, long line, const string& message) {
 	static string Buffer; // max size controlled by Logs system!
 	static Exception Ex;
-	String::Assign(Buffer, String::Log(Logs::LevelToString(level), file, line, message, Thread::CurrentId()));
+	String::Assign(Buffer, String::Log(Logs::LevelToString(level), file, line, message, Logs::ThreadId(), Logs::Now()));
 	if (!_pFile->write(Ex, Buffer.data(), Buffer.size())) {
 		_pFile.reset();
 		return false;
@@ -50,12 +53,22 @@ bool FileLogger::dump(const string& header, const UInt8* data, UInt32 size) {
 	return true;
 }
 
+bool FileLogger::write(const UInt8* data, UInt32 size) {
+	Exception ex;
+	if (!_pFile->write(ex, data, size)) {
+		_pFile.reset();
+		return false;
+	}
+	manage(size);
+	return true;
+}
+
 void FileLogger::manage(UInt32 written) {
 	if (!_sizeByFile || (_written += written) <= _sizeByFile) // don't use _pLogFile->size(true) to avoid disk access on every file log!
 		return; // _logSizeByFile==0 => inifinite log file! (user choice..)
 
 	_written = 0;
-	_pFile.set(Path(_pFile->parent(), "0.log"), File::MODE_WRITE); // override 0.log file!
+	_pFile.set(Path(_pFile->parent(), "0.", _extension), File::MODE_WRITE); // override 0.log file!
 
 	// delete more older file + search the older file name (usefull when _rotation==0 => no rotation!) 
 	string name;
@@ -63,10 +76,10 @@ void FileLogger::manage(UInt32 written) {
 	Exception ex;
 	FileSystem::ForEach forEach([this, &ex, &name, &maxNum](const string& path, UInt16 level) {
 		UInt16 num;
-		if (!String::ToNumber(FileSystem::GetBaseName(path, name), num))
+		if (String::ICompare(FileSystem::GetExtension(path, name), _extension) != 0 || !String::ToNumber(FileSystem::GetBaseName(path, name), num))
 			return true;
 		if (_rotation && num >= (_rotation - 1))
-			FileSystem::Delete(ex, String(_pFile->parent(), num, ".log"));
+			FileSystem::Delete(ex, String(_pFile->parent(), num, '.', _extension));
 		else if (num > maxNum)
 			maxNum = num;
 		return true;
@@ -74,8 +87,9 @@ void FileLogger::manage(UInt32 written) {
 	FileSystem::ListFiles(ex, _pFile->parent(), forEach);
 	// rename log files
 	do {
-		FileSystem::Rename(String(_pFile->parent(), maxNum, ".log"), String(_pFile->parent(), maxNum + 1, ".log"));
+		FileSystem::Rename(String(_pFile->parent(), maxNum, '.', _extension), String(_pFile->parent(), maxNum + 1, '.', _extension));
 	} while (maxNum--);
+	onRotation();
 
 }
 
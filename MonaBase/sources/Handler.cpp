@@ -16,6 +16,7 @@ details (or else see http://mozilla.org/MPL/2.0/).
 
 
 #include "Mona/Handler.h"
+#include <thread>
 
 
 using namespace std;
@@ -23,7 +24,6 @@ using namespace std;
 namespace Mona {
 
 void Handler::reset(Signal& signal) {
-	std::lock_guard<std::mutex> lock(_mutex);
 	_runners.clear();
 	_pSignal = &signal;
 }
@@ -32,11 +32,20 @@ UInt32 Handler::flush(bool last) {
 	// Flush all what is possible now, and not dynamically in real-time (in rechecking _runners)
 	// to keep the possibility to do something else between two flushs!
 	deque<shared<Runner>> runners;
-	{
-		lock_guard<mutex> lock(_mutex);
-		if(last)
-			_pSignal = NULL;
-		runners = move(_runners);
+	if (last) {
+		_pSignal = NULL;
+		// wait queueings which have read _pSignal before its reset, to not miss their runners
+		while (_producers)
+			this_thread::yield();
+		runners.emplace_back();
+		while (_runners.pop(runners.back()))
+			runners.emplace_back();
+		runners.pop_back();
+	} else if (_runners.pop(runners)) {
+		// runners remain without wake-up (coalesced), signal to come back after this batch
+		Signal* pSignal = _pSignal;
+		if (pSignal)
+			pSignal->set();
 	}
 	for (shared<Runner>& pRunner : runners) {
 		pRunner->run('.', pRunner->name); // '.' to signal that its a sub-runner, wait the name of the thread in htop
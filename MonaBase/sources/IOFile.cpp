@@ -15,6 +15,7 @@ details (or else see http://mozilla.org/MPL/2.0/).
 */
 
 #include "Mona/IOFile.h"
+#include "Mona/URing.h"
 #include <list>
 
 using namespace std;
@@ -24,6 +25,7 @@ namespace Mona {
 struct IOFile::Action : Runner, virtual Object {
 	Action(const char* name, const Handler& handler, const shared<File>& pFile) : Runner(name) {
 		pFile->_pHandler = &handler;
+		++pFile->_pending;
 	}
 
 	struct Handle : Runner, virtual Object {
@@ -38,24 +40,47 @@ struct IOFile::Action : Runner, virtual Object {
 		virtual void handle(File& file) = 0;
 		weak<File>	_weakFile;
 	};
+	struct ErrorHandle : Handle, virtual Object {
+		ErrorHandle(const char* name, const shared<File>& pFile, Exception& ex) : Handle(name, pFile), _ex(move(ex)) {}
+	private:
+		void handle(File& file) { file._onError(_ex); }
+		Exception		_ex;
+	};
+	struct FlushHandle : Handle, virtual Object {
+		FlushHandle(const char* name, const shared<File>& pFile) : Handle(name, pFile) {}
+	private:
+		void handle(File& file) {
+			if (!--file._flushing)
+				file._onFlush(!file.loaded());
+		}
+	};
 
-protected:
 	template<typename HandleType, typename ...Args>
-	void handle(const shared<File>& pFile, Args&&... args) {
-		if(!pFile.unique())
+	static void Queue(const char* name, const shared<File>& pFile, Args&&... args) {
+		if (!pFile.unique())
 			pFile->_pHandler->queue<HandleType>(name, pFile, forward<Args>(args)...);
 	}
+	/*!
+	Signal end of write or deletion */
+	static void Flush(const char* name, const shared<File>& pFile) {
+		if (!pFile->_flushing++)
+			Queue<FlushHandle>(name, pFile);
+		else
+			--pFile->_flushing;
+	}
+
+protected:
+	template<typename HandleType, typename ...Args>
+	void handle(const shared<File>& pFile, Args&&... args) { Queue<HandleType>(name, pFile, forward<Args>(args)...); }
 
 	bool run(Exception& ex, const shared<File>& pFile) {
-		if (process(ex, pFile))
-			return true;
-		struct ErrorHandle : Handle, virtual Object {
-			ErrorHandle(const char* name, const shared<File>& pFile, Exception& ex) : Handle(name, pFile), _ex(move(ex)) {}
-		private:
-			void handle(File& file) { file._onError(_ex); }
-			Exception		_ex;
-		};
-		handle<ErrorHandle>(pFile, ex);
+		// wait end of io_uring writings to keep operation order
+		while (pFile->_ringWriting)
+			pFile->_ringWritten.wait();
+		bool success = process(ex, pFile);
+		--pFile->_pending;
+		if (!success)
+			handle<ErrorHandle>(pFile, ex);
 		return true;
 	}
 private:
@@ -87,6 +112,209 @@ private:
 	shared<File> _pFile;
 };
 
+#if defined(URING_API)
+/*!
+io_uring writings, one writing in progress by file at its current position (keep order),
+packets written meanwhile are gathered in the next writing.
+IOFile::write just queues the file, the ring thread submits the writings by batch (one system call) */
+struct IOFile::Ring : URing, Thread, virtual Object {
+	Ring() : URing(RUNNING_MAX), Thread("FileRing"), _writings(0), _sleeping(false) {}
+	~Ring() {
+		if (running()) {
+			lock_guard<mutex> lock(_mutex);
+			if (nop(RING_STOP))
+				submit();
+		}
+		stop();
+	}
+
+	/*!
+	Start the writing of packets in pFile->_writings, pFile->_ringWriting must be set */
+	void write(const shared<File>& pFile) {
+		++_writings;
+		lock_guard<mutex> lock(_mutex);
+		_pendings.emplace_back(new Writing(pFile));
+		if (!_sleeping)
+			return; // ring thread running, will submit it
+		// wake up the ring thread
+		if (nop(RING_WAKEUP) && submit() > 0)
+			_sleeping = false;
+	}
+	/*!
+	Wait end of all writings */
+	void join() {
+		while (_writings)
+			_written.wait();
+	}
+
+private:
+	enum : UInt64 {
+		RING_STOP = 0,
+		RING_WAKEUP = 1
+	};
+	enum {
+		RUNNING_MAX = 0x100 // writings submitted at maximum, SQ size (CQ is 4 times bigger)
+	};
+	struct Writing : virtual Object {
+		Writing(const shared<File>& pFile) : pFile(pFile), size(0) {}
+		const shared<File>	pFile;
+		deque<Packet>		packets;
+		iovec				iovs[64];
+		UInt64				size;
+	};
+
+	/*!
+	Gather the next packets to write of the file, returns false if there is no more (writing deleted) */
+	bool prepare(Writing* pWriting) {
+		if (!pWriting->packets.empty())
+			return true; // already prepared, submission postponed
+		File& file(*pWriting->pFile);
+		{
+			lock_guard<mutex> lock(file._mutexWritings);
+			while (!file._writings.empty() && pWriting->packets.size() < 64) {
+				pWriting->size += file._writings.front().size();
+				pWriting->packets.emplace_back(move(file._writings.front()));
+				file._writings.pop_front();
+			}
+			if (pWriting->packets.empty())
+				file._ringWriting = false;
+		}
+		if (pWriting->packets.empty()) {
+			file._ringWritten.set();
+			delete pWriting;
+			if (!--_writings)
+				_written.set();
+			return false;
+		}
+		gather(*pWriting);
+		return true;
+	}
+	void gather(Writing& writing) {
+		UInt32 count(0);
+		for (const Packet& packet : writing.packets) {
+			writing.iovs[count].iov_base = (void*)packet.data();
+			writing.iovs[count++].iov_len = packet.size();
+		}
+	}
+	/*!
+	Remove the bytes written from a partial writing to resubmit the rest */
+	void consume(Writing& writing, UInt32 size) {
+		writing.pFile->_queueing -= size;
+		writing.size -= size;
+		while (size >= writing.packets.front().size()) {
+			size -= writing.packets.front().size();
+			writing.packets.pop_front();
+		}
+		writing.packets.front() += size;
+		gather(writing);
+	}
+
+	void written(Writing& writing, Exception& ex) {
+		UInt64 queueing = (writing.pFile->_queueing -= writing.size);
+		if (ex)
+			Action::Queue<Action::ErrorHandle>("WriteFile", writing.pFile, ex);
+		else if (!queueing)
+			Action::Flush("WriteFile", writing.pFile);
+		writing.packets.clear();
+		writing.size = 0;
+	}
+
+	bool run(Exception& ex, const volatile bool& requestStop) {
+		deque<Writing*> writings; // to submit
+		UInt32 running(0); // submitted, waiting completion
+		for (;;) {
+			{
+				lock_guard<mutex> lock(_mutex);
+				writings.insert(writings.end(), _pendings.begin(), _pendings.end());
+				_pendings.clear();
+			}
+			UInt32 count(0);
+			auto it(writings.begin());
+			while (it != writings.end() && (running + count) < RUNNING_MAX) {
+				if (prepare(*it)) {
+					++count;
+					++it;
+				} else
+					it = writings.erase(it);
+			}
+			if (count) {
+				int submitted;
+				{
+					lock_guard<mutex> lock(_mutex);
+					UInt32 queued(0);
+					while (queued < count && writev(writings[queued]->pFile->_handle, writings[queued]->iovs, UInt32(writings[queued]->packets.size()), (UInt64)writings[queued]))
+						++queued;
+					submitted = queued ? submit() : 0;
+				}
+				if (submitted > 0) {
+					running += submitted;
+					writings.erase(writings.begin(), writings.begin() + submitted);
+				}
+				if (!running) {
+					// ring refuses the writings (system resources), write synchronously here to not stall them
+					for (UInt32 i = 0; i < count - UInt32(max(submitted, 0)); ++i) {
+						Exception ex;
+						writings[i]->pFile->write(ex, writings[i]->packets);
+						written(*writings[i], ex);
+					}
+					continue; // next packets
+				}
+			}
+			if (!running) {
+				lock_guard<mutex> lock(_mutex);
+				if (!_pendings.empty())
+					continue;
+				_sleeping = true; // wait a writing
+			}
+			if (!wait()) {
+				ex.set<Ex::System::File>("io_uring wait failed, ", strerror(errno));
+				return false;
+			}
+			const io_uring_cqe* pCQE;
+			while ((pCQE = completion())) {
+				UInt64 userData(pCQE->user_data);
+				int result(pCQE->res);
+				next();
+				if (userData == RING_STOP)
+					return true;
+				if (userData == RING_WAKEUP)
+					continue;
+				--running;
+				Writing* pWriting((Writing*)userData);
+				File& file(*pWriting->pFile);
+				Exception ex;
+				if (result > 0 && UInt64(result) < pWriting->size) {
+					// partial writing (signal, disk quota...), resubmit the rest to keep the order, a real error will fail it
+					file._written += result;
+					consume(*pWriting, result);
+					writings.emplace_back(pWriting);
+					continue;
+				}
+				if (result == 0 || result == -ENOSPC || result == -EDQUOT)
+					ex.set<Ex::System::File>("No more disk space to write ", file.path(), " (size=", pWriting->size, ")");
+				else if (result < 0)
+					ex.set<Ex::System::File>("Impossible to write ", file.path(), " (size=", pWriting->size, "), ", strerror(-result));
+				else
+					file._written += result;
+				written(*pWriting, ex);
+				writings.emplace_back(pWriting); // next packets
+			}
+		}
+	}
+
+	std::mutex			_mutex; // protect submissions, _pendings and _sleeping
+	deque<Writing*>		_pendings;
+	bool				_sleeping;
+	std::atomic<UInt32>	_writings;
+	Signal				_written;
+};
+#else
+struct IOFile::Ring : virtual Object {
+	void write(const shared<File>& pFile) {}
+	void join() {}
+};
+#endif
+
 IOFile::IOFile(const Handler& handler, const ThreadPool& threadPool, UInt16 cores) :
 	handler(handler), threadPool(threadPool), _threadPool(Thread::PRIORITY_LOW, cores*2), Thread("FileWatching") { // 2*CPU => because disk speed can be at maximum 2x more than memory, and Low priority to not impact main thread pool
 }
@@ -96,10 +324,32 @@ IOFile::~IOFile() {
 	stop(); // file watchers!
 }
 
+bool IOFile::setBackend(Backend backend) {
+	if (backend == BACKEND_URING) {
+#if defined(URING_API)
+		if (_pRing)
+			return true;
+		unique<Ring> pRing(SET);
+		if (*pRing < 0)
+			return false; // io_uring unsupported
+		pRing->start(Thread::PRIORITY_LOW);
+		_pRing = move(pRing);
+		return true;
+#else
+		return false;
+#endif
+	}
+	join();
+	_pRing.reset();
+	return true;
+}
+
 void IOFile::join() {
 	// join devices (reading and writing operation)	
 	do {
 		((ThreadPool&)threadPool).join(); // wait possible decoding (can cast because IOFile constructor takes a non-const threadPool object)
+		if (_pRing)
+			_pRing->join(); // wait io_uring writings
 	} while(_threadPool.join()); // while reading/writing operation
 }
 
@@ -175,60 +425,84 @@ void IOFile::read(const shared<File>& pFile, UInt32 size) {
 
 void IOFile::write(const shared<File>& pFile, const Packet& packet) {
 	struct WriteFile : SAction { // SAction to allow file writing full asynchronous (without any other hand on the file)
-		WriteFile(const Handler& handler, const shared<File>& pFile, const Packet& packet) : _packet(move(packet)), SAction("WriteFile", handler, pFile) {
-			pFile->_queueing += _packet.size();
+		WriteFile(const Handler& handler, const shared<File>& pFile, const Packet& packet) : SAction("WriteFile", handler, pFile) {
+			_packets.emplace_back(move(packet));
+			pFile->_pWritings = &_packets; // pFile->_mutexWritings locked
 		}
 	private:
-		struct Handle : Action::Handle, virtual Object {
-			Handle(const char* name, const shared<File>& pFile) : Action::Handle(name, pFile) {}
-		private:
-			void handle(File& file) {
-				if(!--file._flushing)
-					file._onFlush(!file.loaded());
-			}
-		};
 		bool process(Exception& ex, const shared<File>& pFile) {
-			UInt64 queueing = (pFile->_queueing -= _packet.size());
-			if (!pFile->write(ex, _packet.data(), _packet.size()))
+			{	// close the batch, next writings will be queued after
+				lock_guard<mutex> lock(pFile->_mutexWritings);
+				if (pFile->_pWritings == &_packets)
+					pFile->_pWritings = NULL;
+			}
+			UInt64 size(0);
+			for (const Packet& packet : _packets)
+				size += packet.size();
+			UInt64 queueing = (pFile->_queueing -= size);
+			if (!pFile->write(ex, _packets))
 				return false;
-			if (queueing)
-				return true;
-			if(!pFile->_flushing++) // To signal end of write!
-				handle<Handle>(pFile);
-			else
-				--pFile->_flushing;
+			if (!queueing) // To signal end of write!
+				Flush(name, pFile);
 			return true;
 		}
-		Packet		 _packet;
+		deque<Packet> _packets;
 	};
 	// do the WriteFile even if packet is empty when not loaded to allow to open the file and clear its content or create the file
 	// or to allow to create the folder => if File is a Folder opened in WRITE/APPEND mode loaded is always false and write an empty packet create the folder => allow a folder creation asynchrone!
-	if(packet || !pFile->loaded())
-		_threadPool.queue<WriteFile>(pFile->_ioTrack, handler, pFile, packet);
+	if (!packet && pFile->loaded())
+		return;
+	pFile->_queueing += packet.size();
+	unique_lock<mutex> lock(pFile->_mutexWritings);
+	if (pFile->_pWritings) { // WriteFile queued, write with it!
+		if (packet)
+			pFile->_pWritings->emplace_back(move(packet));
+		return;
+	}
+	if (_pRing && pFile->loaded() && !pFile->_pending && !pFile->direct()) {
+		// loaded file without any other operation queued => io_uring writing
+		pFile->_writings.emplace_back(move(packet));
+		if (pFile->_ringWriting)
+			return; // will be written with the next writing
+		pFile->_ringWriting = true;
+		lock.unlock();
+		return _pRing->write(pFile);
+	}
+	_threadPool.queue<WriteFile>(pFile->_ioTrack, handler, pFile, packet);
+}
+
+void IOFile::endDirect(const shared<File>& pFile) {
+	struct EndDirect : SAction { // SAction to write it after the unsubscription
+		EndDirect(const Handler& handler, const shared<File>& pFile) : SAction("EndDirect", handler, pFile) {}
+	private:
+		bool process(Exception& ex, const shared<File>& pFile) {
+			if (!pFile->endDirect(ex))
+				ERROR(ex); // no more subscriber to report it
+			return true;
+		}
+	};
+	{	// close the WriteFile batch, next writings have to be queued after
+		lock_guard<mutex> lock(pFile->_mutexWritings);
+		pFile->_pWritings = NULL;
+	}
+	_threadPool.queue<EndDirect>(pFile->_ioTrack, handler, pFile);
 }
 
 void IOFile::erase(const shared<File>& pFile) {
 	struct EraseFile : SAction { // SAction to allow file writing full asynchronous (without any other hand on the file)
 		EraseFile(const Handler& handler, const shared<File>& pFile) : SAction("EraseFile", handler, pFile) {}
 	private:
-		struct Handle : Action::Handle, virtual Object {
-			Handle(const char* name, const shared<File>& pFile) : Action::Handle(name, pFile) {}
-		private:
-			void handle(File& file) {
-				if (!--file._flushing)
-					file._onFlush(!file.loaded());
-			}
-		};
 		bool process(Exception& ex, const shared<File>& pFile) {
 			if (!pFile->erase(ex))
 				return false;
-			if (!pFile->_flushing++) // To signal end of write!
-				handle<Handle>(pFile);
-			else
-				--pFile->_flushing;
+			Flush(name, pFile); // To signal end of write!
 			return true;
 		}
 	};
+	{	// close the WriteFile batch, next writings have to be queued after the deletion
+		lock_guard<mutex> lock(pFile->_mutexWritings);
+		pFile->_pWritings = NULL;
+	}
 	_threadPool.queue<EraseFile>(pFile->_ioTrack, handler, pFile);
 }
 
@@ -26,10 +26,12 @@ details (or else see http://mozilla.org/MPL/2.0/).
     #include "sys/epoll.h"
     #include <vector>
 	#include <fcntl.h>
+	#include <set>
 #if !defined(EPOLLRDHUP)  // ANDROID
 #define EPOLLRDHUP 0x2000 // looks be just a SDL include forget for Android, but the event is implemented in epoll of Android
 #endif  // !defined(EPOLLRDHUP) 
 #endif
+#include "Mona/URing.h"
 #include "Mona/SRT.h"
 #if defined(SRT_API)
 	#include "Mona/IOSRTSocket.h"
@@ -45,6 +47,7 @@ struct IOSocket::Action : Runner, virtual Object {
 		if (error)
 			Socket::SetException(error, _ex);
 	}
+	Action(const char* name, const weak<Socket>& weakSocket) : Runner(name), _weakSocket(weakSocket) {}
 
 protected:
 
@@ -93,8 +96,540 @@ private:
 };
 
 
+#if defined(URING_NET_API)
+/*!
+io_uring reactor of BACKEND_URING, only its thread queues and submits on the ring:
+- the other threads post their requests (subscription, sending, resumption, unsubscription), submitted by batch (one system call) with the rearmings
+- a listening socket accepts on the ring, a connected TCP socket without TLS receives in the buffers provided to the ring and sends its queue on the ring,
+  the other sockets (datagram, TLS, connecting) are polled on the ring and processed as with epoll
+- a reception is given to its Action without copy if large, else copied to give back immediatly its buffer to the ring */
+struct IOSocket::Ring : URing, virtual Object {
+	enum : UInt8 { // operation submitted, in the 3 low bits of user_data (Subscription* in the others)
+		OP_CANCEL = 0, // cancellation, completion ignored
+		OP_WAKEUP, // poll of the pipe of requests
+		OP_POLL, // multishot poll of the sockets processed as with epoll
+		OP_ACCEPT,
+		OP_RECV,
+		OP_SEND,
+		OP_TIMEOUT // delay before a new accept after an accept error
+	};
+	enum : UInt8 {
+		REQUEST_SUBSCRIBE = 0,
+		REQUEST_SEND,
+		REQUEST_RESUME, // reception paused by back-pressure (see Release)
+		REQUEST_UNSUBSCRIBE // always the last request of a subscription
+	};
+	enum {
+		ENTRIES = 0x1000, // SQ size (CQ is 4 times bigger)
+		BUFFERS = 0x100, // buffers provided to the receptions, power of 2
+		BUFFER_SIZE = 0x4000,
+		BUFFER_COPY = 0x800 // reception copied up to this size to give back immediatly its buffer to the ring
+	};
+
+	struct Sending : virtual Object {
+		Sending() : size(0) { memset(&msg, 0, sizeof(msg)); msg.msg_iov = iovs; }
+		shared<Socket>	pSocket; // socket alive until the end of its sending (graceful deletion)
+		msghdr			msg;
+		iovec			iovs[Socket::SEND_GATHER_MAX];
+		UInt32			size;
+	};
+	/*!
+	Socket::_pWeakThis of a socket subscribed, deleted by the reactor after its unsubscription once its operations completed.
+	The operations are submitted asynchronously on a duplicated descriptor, the socket can close its own one meanwhile without
+	that the system reuses it for a new socket (the socket is shutdown on deletion anyway) */
+	struct Subscription : weak<Socket> {
+		Subscription(const shared<Socket>& pSocket) : weak<Socket>(pSocket), fd(dup(*pSocket)), running(0), unsubscribed(false), addressSize(0),
+			mode(pSocket->listening() ? OP_ACCEPT : ((pSocket->type == Socket::TYPE_STREAM && !pSocket->isSecure() && pSocket->peerAddress() && !pSocket->getZeroCopy()) ? OP_RECV : OP_POLL)) {}
+		~Subscription() { if (fd >= 0) ::close(fd); }
+		const int			fd;
+		const UInt8			mode; // operation of reception, OP_POLL, OP_ACCEPT or OP_RECV
+		UInt8				running; // operations in flight, one bit by operation
+		bool				unsubscribed;
+		unique<Sending>		pSending;
+		union {
+			sockaddr_in  sa_in;
+			sockaddr_in6 sa_in6;
+		}					address; // address of the connection accepted
+		socklen_t			addressSize;
+		__kernel_timespec	delay;
+	};
+
+	Ring(IOSocket& io) : URing(ENTRIES), _io(io), _running(0), _queued(0), _error(0) {}
+
+	/*!
+	Provide the reception buffers to the ring, returns false if unsupported by the system */
+	bool init() {
+		if (self < 0 || !setBuffers(BUFFERS))
+			return false;
+		for (UInt16 id = 0; id < BUFFERS; ++id)
+			provide(id, _buffers[id].set(BUFFER_SIZE).data(), BUFFER_SIZE);
+		return true;
+	}
+
+	/*!
+	Requests of the other threads, IOSocket::_mutexRing must be locked */
+	Subscription* subscribe(const shared<Socket>& pSocket) {
+		Subscription* pSubscription(new Subscription(pSocket));
+		if (pSubscription->fd < 0) {
+			delete pSubscription;
+			return NULL;
+		}
+		pSocket->_ring = pSubscription->mode == OP_RECV;
+		post(pSubscription, REQUEST_SUBSCRIBE);
+		return pSubscription;
+	}
+	void unsubscribe(Socket& socket) {
+		if (!socket._pWeakThis)
+			return;
+		post((Subscription*)socket._pWeakThis, REQUEST_UNSUBSCRIBE);
+		socket._pWeakThis = NULL; // deleted by the reactor
+	}
+	void post(Subscription* pSubscription, UInt8 type, shared<Socket>&& pSocket = nullptr) {
+		if (_requests.empty()) {
+			// wake up the reactor, fails just if the pipe is full (reactor already waked up)
+			ssize_t written = ::write(_io._eventFD, &type, sizeof(type));
+			(void)written;
+		}
+		_requests.emplace_back(pSubscription, type, std::move(pSocket));
+	}
+
+	/*!
+	Release count receptions (bytes or connections) handled, resumes the reception if it has been paused and is now under limit */
+	static void Release(Socket& socket, UInt32 count, UInt32 limit) {
+		if ((socket._receiving -= count) >= limit)
+			return;
+		UInt8 paused(1);
+		if (!socket._reading.compare_exchange_strong(paused, 0))
+			return;
+		IOSocket* pIOSocket(socket._pIOSocket);
+		if (!pIOSocket)
+			return; // unsubscribed
+		lock_guard<mutex> lock(pIOSocket->_mutexRing);
+		if (pIOSocket->_pRing && socket._pWeakThis)
+			pIOSocket->_pRing->post((Subscription*)socket._pWeakThis, REQUEST_RESUME);
+	}
+
+	bool run(Exception& ex, int readFD) {
+		vector<Request> requests;
+		prepare();
+		poll(readFD, POLLIN, OP_WAKEUP);
+		bool stop(false);
+		for (;;) {
+			{
+				lock_guard<mutex> lock(_io._mutexRing);
+				requests.swap(_requests);
+			}
+			for (Request& request : requests)
+				execute(request);
+			requests.clear();
+			if (!submit() || !wait())
+				break;
+			bool terminate(false);
+			const io_uring_cqe* pCQE;
+			// for each completion
+			while ((pCQE = completion())) {
+				UInt64 userData(pCQE->user_data);
+				int result(pCQE->res);
+				UInt32 flags(pCQE->flags);
+				next();
+				if (!(flags & IORING_CQE_F_MORE))
+					--_running;
+				UInt8 op(userData & 7);
+				if (op == OP_CANCEL)
+					continue;
+				if (op == OP_WAKEUP) {
+					if (result < 0 || (result & POLLHUP)) {
+						terminate = true; // termination signal on IOSocket deletion
+						continue;
+					}
+					UInt8 wakeUps[64];
+					while (::read(readFD, wakeUps, sizeof(wakeUps)) > 0);
+					prepare();
+					poll(readFD, POLLIN, OP_WAKEUP);
+					continue;
+				}
+				complete(*(Subscription*)(userData & ~UInt64(7)), op, result, flags);
+			}
+			if (terminate)
+				break; // termination signal on IOSocket deletion
+			if (_io._subscribers || !_subscriptions.empty())
+				continue;
+			lock_guard<mutex> lock(_io._mutex);
+			// no more socket to manage? (and all the operations of the unsubscriptions completed)
+			if (_io._subscribers)
+				continue;
+			{
+				lock_guard<mutex> lockRing(_io._mutexRing);
+				if (!_requests.empty())
+					continue;
+			}
+			_io.stop(); // to set running=false!
+			stop = true;
+			break;
+		}
+		if (_error)
+			ex.set<Ex::Net::System>("impossible to manage sockets, io_uring ", strerror(_error));
+
+		// cancel the operations in flight and wait their end to release their resources
+		prepare();
+		cancel(0, OP_CANCEL);
+		if (submit()) {
+			const io_uring_cqe* pCQE;
+			while (_running && wait()) {
+				while ((pCQE = completion())) {
+					if (!(pCQE->flags & IORING_CQE_F_MORE))
+						--_running;
+					if ((pCQE->user_data & 7) == OP_ACCEPT && pCQE->res >= 0)
+						NET_CLOSESOCKET(pCQE->res); // connection accepted meanwhile
+					next();
+				}
+			}
+		}
+		for (Subscription* pSubscription : _subscriptions) {
+			shared<Socket> pSocket(pSubscription->lock());
+			if (pSocket) {
+				// remaining socket, detach it (unsubscribe will ignore it)
+				lock_guard<mutex> lock(_io._mutexRing);
+				if (pSocket->_pWeakThis == pSubscription)
+					pSocket->_pWeakThis = NULL;
+			}
+			if (pSubscription->pSending && (pSocket = move(pSubscription->pSending->pSocket))) {
+				lock_guard<mutex> lock(pSocket->_mutexSending);
+				pSocket->_sending = false;
+			}
+			delete pSubscription;
+		}
+		if (stop || _error)
+			return !_error;
+		if (!_io._subscribers)
+			return true; // IOSocket deletion
+		ex.set<Ex::Net::System>("dies with remaining sockets managed");
+		return false;
+	}
+
+private:
+	struct Request {
+		Request(Subscription* pSubscription, UInt8 type, shared<Socket>&& pSocket) : pSubscription(pSubscription), type(type), pSocket(std::move(pSocket)) {}
+		Subscription*	pSubscription;
+		UInt8			type;
+		shared<Socket>	pSocket; // sending request, keeps the socket alive until its sending
+	};
+
+	struct Receive : Action {
+		Receive(const shared<Socket>& pSocket, shared<Buffer>& pBuffer) : Action("SocketReceive", 0, pSocket), _pBuffer(std::move(pBuffer)) {}
+	private:
+		struct Handle : Action::Handle {
+			Handle(const char* name, const shared<Socket>& pSocket, const Exception& ex, shared<Buffer>& pBuffer, UInt32 size) :
+				Action::Handle(name, pSocket, ex), _pBuffer(std::move(pBuffer)), _size(size) {}
+		private:
+			void handle(const shared<Socket>& pSocket) {
+				pSocket->_onReceived(_pBuffer, pSocket->peerAddress());
+				Release(*pSocket, _size, pSocket->recvBufferSize());
+			}
+			shared<Buffer>	_pBuffer;
+			UInt32			_size;
+		};
+		bool process(Exception& ex, const shared<Socket>& pSocket) {
+			UInt32 size(_pBuffer->size());
+			// decode can't happen BEFORE onDisconnection because this call decode + push to _handler in this call!
+			if (pSocket->_pDecoder)
+				pSocket->_pDecoder->decode(_pBuffer, pSocket->peerAddress(), pSocket);
+			if (_pBuffer)
+				handle<Handle>(pSocket, _pBuffer, size);
+			else
+				Release(*pSocket, size, pSocket->recvBufferSize()); // captured by the decoder
+			return true;
+		}
+		shared<Buffer> _pBuffer;
+	};
+
+	struct Accept : Action {
+		Accept(const shared<Socket>& pSocket, NET_SOCKET sockfd, const Subscription& subscription) : Action("SocketAccept", 0, pSocket), _sockfd(sockfd) {
+			memcpy(&_address, &subscription.address, sizeof(_address));
+		}
+		~Accept() {
+			if (_sockfd != NET_INVALID_SOCKET)
+				NET_CLOSESOCKET(_sockfd); // not handled
+		}
+	private:
+		struct Handle : Action::Handle {
+			Handle(const char* name, const shared<Socket>& pSocket, const Exception& ex, shared<Socket>& pConnection) :
+				Action::Handle(name, pSocket, ex), _pConnection(std::move(pConnection)) {}
+		private:
+			void handle(const shared<Socket>& pSocket) {
+				pSocket->_onAccept(_pConnection);
+				Release(*pSocket, 1, Socket::BACKLOG_MAX);
+			}
+			shared<Socket>	_pConnection;
+		};
+		bool process(Exception& ex, const shared<Socket>& pSocket) {
+			shared<Socket> pConnection;
+			pConnection = pSocket->newSocket(ex, _sockfd, (sockaddr&)_address);
+			if (!pConnection) {
+				Release(*pSocket, 1, Socket::BACKLOG_MAX);
+				return false;
+			}
+			_sockfd = NET_INVALID_SOCKET;
+			handle<Handle>(pSocket, pConnection);
+			return true;
+		}
+		NET_SOCKET	_sockfd;
+		union {
+			sockaddr_in  sa_in;
+			sockaddr_in6 sa_in6;
+		}			_address;
+	};
+
+	/*!
+	Reserve an entry in the SQ, submits it if full */
+	void prepare() {
+		if (_queued == ENTRIES)
+			submit();
+		++_queued;
+	}
+	/*!
+	Submit the entries queued, returns false on error (entries withdrawn, the reactor stops) */
+	bool submit() {
+		if (!_queued)
+			return !_error;
+		int result(URing::submit());
+		if (result > 0)
+			_running += result;
+		if (result < int(_queued) && !_error)
+			_error = result < 0 ? errno : EAGAIN;
+		_queued = 0;
+		return !_error;
+	}
+
+	void execute(Request& request) {
+		Subscription& subscription(*request.pSubscription);
+		switch (request.type) {
+			case REQUEST_SUBSCRIBE:
+				_subscriptions.emplace(&subscription);
+				if (subscription.mode == OP_RECV) {
+					shared<Socket> pSocket(subscription.lock());
+					if (pSocket) // connected, first onFlush as on the first writable event
+						_io.write(pSocket, 0);
+				}
+				return arm(subscription, subscription.mode);
+			case REQUEST_SEND:
+				return send(subscription, request.pSocket);
+			case REQUEST_RESUME:
+				if (!(subscription.running & (1 << subscription.mode)))
+					arm(subscription, subscription.mode);
+				return;
+			default: // REQUEST_UNSUBSCRIBE
+				subscription.unsubscribed = true;
+				for (UInt8 op = OP_POLL; op <= OP_TIMEOUT; ++op) {
+					if (!(subscription.running & (1 << op)))
+						continue;
+					prepare();
+					cancel(UInt64(&subscription) | op, OP_CANCEL);
+				}
+				release(subscription);
+		}
+	}
+
+	void arm(Subscription& subscription, UInt8 op) {
+		UInt64 userData(UInt64(&subscription) | op);
+		prepare();
+		switch (op) {
+			case OP_POLL:
+				poll(subscription.fd, POLLIN | POLLOUT | POLLRDHUP, userData, true);
+				break;
+			case OP_ACCEPT:
+				subscription.addressSize = sizeof(subscription.address);
+				accept(subscription.fd, (sockaddr*)&subscription.address, &subscription.addressSize, userData);
+				break;
+			case OP_RECV:
+				recv(subscription.fd, userData);
+				break;
+			default: // OP_TIMEOUT
+				subscription.delay.tv_sec = 0;
+				subscription.delay.tv_nsec = 100000000; // 100ms
+				timeout(&subscription.delay, userData);
+		}
+		subscription.running |= 1 << op;
+	}
+	/*!
+	Pause the reception of socket over limit, Release resumes it */
+	void pause(Subscription& subscription, Socket& socket, UInt32 limit) {
+		socket._reading = 1;
+		UInt8 paused(1);
+		if (socket._receiving < limit && socket._reading.compare_exchange_strong(paused, 0))
+			arm(subscription, subscription.mode); // released meanwhile
+	}
+	/*!
+	Delete subscription if unsubscribed and without operation in flight */
+	void release(Subscription& subscription) {
+		if (!subscription.unsubscribed || subscription.running)
+			return;
+		_subscriptions.erase(&subscription);
+		delete &subscription;
+	}
+
+	/*!
+	Give back the buffer id to the ring, returns the reception (without copy if large) */
+	shared<Buffer> take(UInt16 id, int result) {
+		shared<Buffer> pBuffer;
+		shared<Buffer>& pSlot(_buffers[id]);
+		if (result > BUFFER_COPY) {
+			pBuffer = std::move(pSlot);
+			pBuffer->resize(result);
+			pSlot.set(BUFFER_SIZE);
+		} else if (result > 0)
+			pBuffer.set(pSlot->data(), result);
+		provide(id, pSlot->data(), BUFFER_SIZE);
+		return pBuffer;
+	}
+
+	void send(Subscription& subscription, shared<Socket>& pSocket) {
+		if (!pSocket)
+			return;
+		Socket& socket(*pSocket);
+		if (!subscription.pSending)
+			subscription.pSending.set();
+		Sending& sending(*subscription.pSending);
+		int flags;
+		{
+			lock_guard<mutex> lock(socket._mutexSending);
+			if (socket._sendings.empty()) {
+				socket._sending = false;
+				return;
+			}
+			// gather the front packets with same flags (sendmsg has just one flags argument)
+			flags = socket._sendings.front().flags;
+			UInt32 count(0);
+			sending.size = 0;
+			for (const Socket::Sending& packet : socket._sendings) {
+				if (count == Socket::SEND_GATHER_MAX || packet.flags != flags)
+					break;
+				sending.iovs[count].iov_base = (void*)packet.data();
+				sending.iovs[count++].iov_len = packet.size();
+				sending.size += packet.size();
+			}
+			sending.msg.msg_iovlen = count;
+		}
+		sending.pSocket = std::move(pSocket);
+		prepare();
+		sendmsg(subscription.fd, &sending.msg, flags | MSG_NOSIGNAL, UInt64(&subscription) | OP_SEND);
+		subscription.running |= 1 << OP_SEND;
+	}
+
+	void sent(Subscription& subscription, int result) {
+		shared<Socket> pSocket(std::move(subscription.pSending->pSocket));
+		Socket& socket(*pSocket);
+		bool sending(false);
+		{
+			lock_guard<mutex> lock(socket._mutexSending);
+			if (result >= 0) {
+				socket.send(UInt32(result));
+				socket._queueing -= result;
+				UInt32 size(result);
+				while (!socket._sendings.empty() && size >= socket._sendings.front().size()) {
+					size -= socket._sendings.front().size();
+					socket._sendings.pop_front();
+				}
+				if (size) // partially sent
+					socket._sendings.front() += size;
+				sending = !subscription.unsubscribed && !socket._sendings.empty();
+			} else if (result != -ECANCELED) {
+				// RELIABILITY IMPOSSIBLE => shutdown system to avoid to try to send before shutdown!
+				socket._sendings.clear();
+				socket._queueing = 0;
+				socket._ring = false; // next writes fail on the socket closed
+				socket.close();
+			} // else canceled by the unsubscription, the socket flushes its queue on deletion
+			if (!sending) {
+				if (socket._sendings.empty()) {
+					if (result >= 0 && !subscription.unsubscribed)
+						_io.write(pSocket, 0); // onFlush
+					if (socket._shutdown)
+						socket.close(Socket::SHUTDOWN_SEND);
+				}
+				socket._sending = false;
+			}
+		}
+		if (result < 0 && result != -ECANCELED && !subscription.unsubscribed)
+			_io.threadPool.queue<Action>(socket._threadReceive, "SocketSend", -result, pSocket);
+		if (sending)
+			return send(subscription, pSocket);
+		release(subscription);
+		// pSocket released out of the lock, can be the last reference
+	}
+
+	void complete(Subscription& subscription, UInt8 op, int result, UInt32 flags) {
+		shared<Buffer> pBuffer;
+		if (flags & IORING_CQE_F_BUFFER)
+			pBuffer = take(flags >> IORING_CQE_BUFFER_SHIFT, result);
+		if (!(flags & IORING_CQE_F_MORE))
+			subscription.running &= ~(1 << op);
+		if (op == OP_SEND)
+			return sent(subscription, result);
+		shared<Socket> pSocket;
+		if (subscription.unsubscribed || !(pSocket = subscription.lock())) {
+			if (op == OP_ACCEPT && result >= 0)
+				NET_CLOSESOCKET(result);
+			return release(subscription);
+		}
+		switch (op) {
+			case OP_POLL:
+				if (result > 0)
+					_io.process(pSocket, result);
+				if (!(flags & IORING_CQE_F_MORE))
+					arm(subscription, OP_POLL); // multishot poll stopped by the kernel (CQ overflow for example), rearm it
+				return;
+			case OP_ACCEPT:
+				if (result >= 0) {
+					UInt32 receiving(++pSocket->_receiving);
+					_io.threadPool.queue<Accept>(pSocket->_threadReceive, pSocket, result, subscription);
+					if (receiving < Socket::BACKLOG_MAX)
+						arm(subscription, OP_ACCEPT);
+					else
+						pause(subscription, *pSocket, Socket::BACKLOG_MAX);
+				} else if (result == -EINTR || result == -EAGAIN || result == -ECONNABORTED)
+					arm(subscription, OP_ACCEPT);
+				else {
+					// no more file descriptor for example, retry later to not loop on the error
+					_io.threadPool.queue<Action>(pSocket->_threadReceive, "SocketAccept", -result, pSocket);
+					arm(subscription, OP_TIMEOUT);
+				}
+				return;
+			case OP_TIMEOUT:
+				return arm(subscription, OP_ACCEPT);
+			default: // OP_RECV
+				if (result > 0) {
+					pSocket->receive(UInt32(result));
+					UInt32 receiving(pSocket->_receiving += result);
+					_io.threadPool.queue<Receive>(pSocket->_threadReceive, pSocket, pBuffer);
+					if (receiving < pSocket->recvBufferSize())
+						arm(subscription, OP_RECV);
+					else
+						pause(subscription, *pSocket, pSocket->recvBufferSize());
+				} else if (!result) // disconnection
+					_io.close(pSocket, 0);
+				else if (result == -ENOBUFS || result == -EINTR || result == -EAGAIN)
+					arm(subscription, OP_RECV);
+				else
+					_io.close(pSocket, -result);
+		}
+	}
+
+	IOSocket&				_io;
+	vector<Request>			_requests; // protected by IOSocket::_mutexRing
+	shared<Buffer>			_buffers[BUFFERS];
+	set<Subscription*>		_subscriptions;
+	UInt32					_running; // operations in flight
+	UInt32					_queued; // entries queued not submitted
+	int						_error;
+};
+#else
+struct IOSocket::Ring : virtual Object {};
+#endif
+
+
 IOSocket::IOSocket(const Handler& handler, const ThreadPool& threadPool, const char* name) : _initSignal(false),
-   _system(0), Thread(name),_subscribers(0),handler(handler), threadPool(threadPool) {
+   _system(0), Thread(name),_subscribers(0),handler(handler), threadPool(threadPool), _nextThread(0), _pinned(false), _backend(BACKEND_SYSTEM) {
 }
 
 IOSocket::~IOSocket() {
@@ -155,7 +690,71 @@ bool IOSocket::subscribe(Exception& ex, const shared<Socket>& pSocket,
 	return false;
 }
 
+UInt32 IOSocket::subscribers() const {
+	UInt32 subscribers(_subscribers);
+	for (const unique<IOSocket>& pShard : _shards)
+		subscribers += pShard->subscribers();
+	return subscribers;
+}
+
+bool IOSocket::setShards(Exception& ex, UInt16 shards) {
+#if defined(_WIN32) || defined(_BSD)
+	if (shards < 2)
+		return true;
+	ex.set<Ex::Unsupported>(name(), " sharding requires epoll, unsupported on this platform");
+	return false;
+#else
+	lock_guard<mutex> lock(_mutex);
+	if (UInt32 count = subscribers()) {
+		ex.set<Ex::Intern>(name(), " sharding must be set before any subscription, ", count, " sockets already subscribed");
+		return false;
+	}
+	_shards.clear();
+	if (shards < 2)
+		return true;
+	_shards.reserve(shards);
+	while (_shards.size() < shards) {
+		_shards.emplace_back(new IOSocket(handler, threadPool, name()));
+		_shards.back()->_pinned = true;
+		_shards.back()->_backend = _backend;
+	}
+	return true;
+#endif
+}
+
+bool IOSocket::setBackend(Exception& ex, Backend backend) {
+	if (backend == BACKEND_URING) {
+#if defined(URING_NET_API)
+		URing ring(1);
+		if (ring < 0 || !ring.setBuffers(1)) { // test io_uring support with provided buffers
+			ex.set<Ex::Unsupported>(name(), " io_uring backend unsupported by the system, Linux >= 5.19 required");
+			return false;
+		}
+#else
+		ex.set<Ex::Unsupported>(name(), " io_uring backend unsupported on this platform");
+		return false;
+#endif
+	}
+	lock_guard<mutex> lock(_mutex);
+	if (UInt32 count = subscribers()) {
+		ex.set<Ex::Intern>(name(), " backend must be set before any subscription, ", count, " sockets already subscribed");
+		return false;
+	}
+	_backend = backend;
+	for (unique<IOSocket>& pShard : _shards)
+		pShard->_backend = backend;
+	return true;
+}
+
+IOSocket& IOSocket::shard(Socket& socket) {
+	if (!socket._threadReceive) // assign the thread of reception to fix the shard
+		socket._threadReceive = (_nextThread++ % threadPool.threads()) + 1;
+	return *_shards[(socket._threadReceive - 1) % _shards.size()];
+}
+
 bool IOSocket::subscribe(Exception& ex, const shared<Socket>& pSocket) {
+	if (!_shards.empty())
+		return shard(*pSocket).subscribe(ex, pSocket);
 	lock_guard<mutex> lock(_mutex); // must protect "start" + _system (to avoid a write operation on restarting) + _subscribers increment
 	if (!running()) {
 		_initSignal.reset();
@@ -176,21 +775,31 @@ bool IOSocket::subscribe(Exception& ex, const shared<Socket>& pSocket) {
 	}
 	_sockets.emplace(*pSocket, pSocket);
 #else
-	pSocket->_pWeakThis = new weak<Socket>(pSocket);
 	int res;
 #if defined(_BSD)
+	pSocket->_pWeakThis = new weak<Socket>(pSocket);
 	struct kevent events[2];
 	// no need to look EV_EOF, set automatically!
 	EV_SET(&events[0], *pSocket, EVFILT_READ, EV_ADD | EV_CLEAR, 0, 0, pSocket->_pWeakThis);
 	EV_SET(&events[1], *pSocket, EVFILT_WRITE, EV_ADD | EV_CLEAR, 0, 0, pSocket->_pWeakThis);
 	res = kevent(_system, events, 2, NULL, 0, NULL);
 #else
-	epoll_event event;
-	memset(&event, 0, sizeof(event));
-	event.events = EPOLLIN | EPOLLRDHUP | EPOLLOUT | EPOLLET;
-	event.data.fd = *pSocket;
-	event.data.ptr = pSocket->_pWeakThis;
-	res = epoll_ctl(_system, EPOLL_CTL_ADD, *pSocket, &event);
+#if defined(URING_NET_API)
+	if (_pRing) {
+		// the subscription of the ring is the weak<Socket> of the socket
+		lock_guard<mutex> lockRing(_mutexRing);
+		res = (pSocket->_pWeakThis = _pRing->subscribe(pSocket)) ? 0 : -1;
+	} else
+#endif
+	{
+		pSocket->_pWeakThis = new weak<Socket>(pSocket);
+		epoll_event event;
+		memset(&event, 0, sizeof(event));
+		event.events = EPOLLIN | EPOLLRDHUP | EPOLLOUT | EPOLLET;
+		event.data.fd = *pSocket;
+		event.data.ptr = pSocket->_pWeakThis;
+		res = epoll_ctl(_system, EPOLL_CTL_ADD, *pSocket, &event);
+	}
 #endif
 	if (res<0) {
 		delete pSocket->_pWeakThis;
@@ -199,6 +808,8 @@ bool IOSocket::subscribe(Exception& ex, const shared<Socket>& pSocket) {
 		return false;
 	}
 #endif
+	pSocket->_weakSocket = pSocket;
+	pSocket->_pIOSocket = this;
 	++_subscribers;
 	
 	return true;
@@ -222,6 +833,9 @@ void IOSocket::unsubscribe(shared<Socket>& pSocket) {
 }
 
 void IOSocket::unsubscribe(Socket* pSocket) {
+	if (!_shards.empty())
+		return shard(*pSocket).unsubscribe(pSocket);
+	pSocket->_pIOSocket = NULL; // no more batched flush request, Socket flushes its queue on deletion
 #if defined(_WIN32)
 	{
 		// decrements _count before the PostMessage
@@ -252,11 +866,21 @@ void IOSocket::unsubscribe(Socket* pSocket) {
 		EV_SET(&events[1], *pSocket, EVFILT_WRITE, EV_DELETE, 0, 0, NULL);
 		kevent(_system, events, 2, NULL, 0, NULL);
 #else
-		epoll_event event;
-		memset(&event, 0, sizeof(event));
-		epoll_ctl(_system, EPOLL_CTL_DEL, *pSocket, &event);
+#if defined(URING_NET_API)
+		{
+			lock_guard<mutex> lockRing(_mutexRing);
+			if (_pRing)
+				_pRing->unsubscribe(*pSocket); // subscription deleted by the reactor once its operations completed
+		}
+		if (pSocket->_pWeakThis)
 #endif
-		if (::write(_eventFD, &pSocket->_pWeakThis, sizeof(pSocket->_pWeakThis)) >= 0)
+		{
+			epoll_event event;
+			memset(&event, 0, sizeof(event));
+			epoll_ctl(_system, EPOLL_CTL_DEL, *pSocket, &event);
+		}
+#endif
+		if (pSocket->_pWeakThis && ::write(_eventFD, &pSocket->_pWeakThis, sizeof(pSocket->_pWeakThis)) >= 0)
 			pSocket->_pWeakThis = NULL; // success!
 	}
 	if (pSocket->_pWeakThis) {
@@ -329,8 +953,8 @@ void IOSocket::read(const shared<Socket>& pSocket, int error) {
 		struct Handle : Action::Handle {
 			Handle(const char* name, const shared<Socket>& pSocket, const Exception& ex, shared<Buffer>& pBuffer, const SocketAddress& address, bool& stop) :
 				Action::Handle(name, pSocket, ex), _address(address), _pBuffer(move(pBuffer)), _pThread(NULL) {
-				if ((pSocket->_receiving += _pBuffer->size()) < pSocket->recvBufferSize())
-					return;
+				if ((pSocket->_receiving += _pBuffer->size()) < pSocket->recvBufferSize() || stop)
+					return; // not full or already stopped (batch reception)
 				stop = true;
 				_pThread = ThreadQueue::Current();
 				++pSocket->_reading;
@@ -355,6 +979,8 @@ void IOSocket::read(const shared<Socket>& pSocket, int error) {
 		bool process(Exception& ex, const shared<Socket>& pSocket) {
 			if (!pSocket->_reading--) // me and something else! useless!
 				return true;
+			if (pSocket->type == Socket::TYPE_DATAGRAM)
+				return processDatagrams(ex, pSocket);
 			bool stop(false);
 			while (!stop) {
 				UInt32 available = pSocket->available();
@@ -392,6 +1018,35 @@ void IOSocket::read(const shared<Socket>& pSocket, int error) {
 			};
 			return true;
 		}
+
+		bool processDatagrams(Exception& ex, const shared<Socket>& pSocket) {
+			// Batched reception, the slots without datagram (or not captured) are reused by the next system call of this reception
+			shared<Buffer>	pBuffers[Socket::RECV_BATCH_MAX];
+			SocketAddress	addresses[Socket::RECV_BATCH_MAX];
+			bool stop(false);
+			while (!stop) {
+				int received = pSocket->receive(ex, pBuffers, addresses, Socket::RECV_BATCH_MAX);
+				if (received < 0) {
+					if (ex.cast<Ex::Net::Socket>().code != NET_ESHUTDOWN) {
+						// if NET_EMSGSIZE => UDP packet lost! (can happen on windows! error displaid!)
+						if (ex.cast<Ex::Net::Socket>().code != NET_EWOULDBLOCK)
+							return false;
+					} else
+						pSocket->_reading = 0xFF; // block reception!
+					ex = nullptr;
+					return true;
+				}
+				if (pSocket->_pDecoder)
+					pSocket->_pDecoder->decodeBatch(pBuffers, addresses, received, pSocket);
+				for (int i = 0; i < received; ++i) {
+					if (pBuffers[i])
+						handle<Handle>(pSocket, pBuffers[i], addresses[i], stop);
+				}
+				if (ex) // datagram truncated (lost), displays it as for a NET_EMSGSIZE
+					return false;
+			}
+			return true;
+		}
 	};
 
 	threadPool.queue<Receive>(pSocket->_threadReceive, error, pSocket);
@@ -425,9 +1080,23 @@ void IOSocket::write(const shared<Socket>& pSocket, int error) {
 			}
 		};
 	};
+	if (_pinned)
+		return threadPool.queue<Send>(pSocket->_threadReceive, error, pSocket);
 	threadPool.queue<Send>(0, error, pSocket);
 }
 
+void IOSocket::flush(Socket& socket) {
+	struct Flush : Action {
+		Flush(const weak<Socket>& weakSocket) : Action("SocketFlush", weakSocket) {}
+	private:
+		// onFlush is raised by the write event if the socket becomes busy
+		bool process(Exception& ex, const shared<Socket>& pSocket) { return pSocket->flush(ex); }
+	};
+	if (_pinned)
+		return threadPool.queue<Flush>(socket._threadReceive, socket._weakSocket);
+	threadPool.queue<Flush>(0, socket._weakSocket);
+}
+
 
 void IOSocket::close(const shared<Socket>& pSocket, int error) {
 	//::printf("CLOSE(%d) socket %d\n", error, pSocket->id());
@@ -489,8 +1158,19 @@ bool IOSocket::run(Exception& ex, const volatile bool& requestStop) {
         _system = kqueue();
 #else
 	epoll_event events[MAXEVENTS];
-	if(readFD>0 && _eventFD>0 && fcntl(readFD, F_SETFL, fcntl(readFD, F_GETFL, 0) | O_NONBLOCK)!=-1)
+	if(readFD>0 && _eventFD>0 && fcntl(readFD, F_SETFL, fcntl(readFD, F_GETFL, 0) | O_NONBLOCK)!=-1) {
+#if defined(URING_NET_API)
+		if (_backend == BACKEND_URING) {
+			unique<Ring> pRing(SET, self);
+			if (pRing->init()) {
+				_system = *pRing;
+				lock_guard<mutex> lock(_mutexRing);
+				_pRing = move(pRing);
+			}
+		} else
+#endif
 		_system = epoll_create(MAXEVENTS); // Argument is ignored on new system, otherwise must be >= to events[] size
+	}
 #endif
 	if(_system<=0) {
 		if(_eventFD>0)
@@ -504,12 +1184,17 @@ bool IOSocket::run(Exception& ex, const volatile bool& requestStop) {
 		struct kevent event;
         EV_SET(&event, readFD, EVFILT_READ, EV_ADD, 0, 0, NULL);
         kevent(_system, &event, 1, NULL, 0, NULL);
-#else    
-        epoll_event event;
-        memset(&event, 0, sizeof(event));
-        event.events = EPOLLIN;
-        event.data.fd = readFD;
-        epoll_ctl(_system, EPOLL_CTL_ADD,readFD, &event);
+#else
+#if defined(URING_NET_API)
+		if (!_pRing) // polled on the ring by Ring::run
+#endif
+		{
+			epoll_event event;
+			memset(&event, 0, sizeof(event));
+			event.events = EPOLLIN;
+			event.data.fd = readFD;
+			epoll_ctl(_system, EPOLL_CTL_ADD, readFD, &event);
+		}
 #endif
 	}
 #endif
@@ -581,6 +1266,15 @@ bool IOSocket::run(Exception& ex, const volatile bool& requestStop) {
 	}
 
 #else
+#if defined(URING_NET_API)
+	if (_pRing) {
+		bool success(_pRing->run(ex, readFD));
+		::close(readFD);  // close reader pipe side
+		lock_guard<mutex> lock(_mutexRing);
+		_pRing.reset(); // close the system message
+		return success;
+	}
+#endif
 	vector<weak<Socket>*>	removedSockets;
 
 	for (;;) {
@@ -655,34 +1349,8 @@ bool IOSocket::run(Exception& ex, const volatile bool& requestStop) {
 			}
 
 			shared<Socket> pSocket(reinterpret_cast<weak<Socket>*>(event.data.ptr)->lock());
-			if(!pSocket)
-				continue; // socket error
-			// EPOLLIN | EPOLLOUT | EPOLLERR | EPOLLHUP | EPOLLRDHUP
-			//printf("%d => 0x%08x\n", pSocket->id(), event.events);
-			int error = 0;
-			if(event.events&EPOLLERR) {
-				socklen_t len(sizeof(error));
-				if(getsockopt(pSocket->id(), SOL_SOCKET, SO_ERROR, (void *)&error, &len)==-1)
-					error = Net::LastError();
-			}
-			if (event.events&EPOLLRDHUP) {
-				// disconnection
-				close(pSocket, error);
-				continue;
-			}
-			if (!(event.events&EPOLLHUP)) { // if socket unexpected close no more read or write!
-				// EPOLLOUT in first to get the onFlush (onConnection for TCP) in first (before any reception)
-				if (event.events&EPOLLOUT) {
-					write(pSocket, error);
-					error = 0;
-				}
-				if (event.events&EPOLLIN) {
-					read(pSocket, error);
-					error = 0;
-				}
-			}
-			if (error) // on few unix system we can get an error without anything else
-				threadPool.queue<Action>(pSocket->_threadReceive, "SocketError", error, pSocket);
+			if(pSocket)
+				process(pSocket, event.events);
 #endif
 		}
 
@@ -722,7 +1390,50 @@ bool IOSocket::run(Exception& ex, const volatile bool& requestStop) {
 	return false;
 }
 	
+#if !defined(_WIN32) && !defined(_BSD)
+void IOSocket::process(const shared<Socket>& pSocket, UInt32 events) {
+	// EPOLLIN | EPOLLOUT | EPOLLERR | EPOLLHUP | EPOLLRDHUP (same values with io_uring poll)
+	//printf("%d => 0x%08x\n", pSocket->id(), events);
+	int error = 0;
+	if(events&EPOLLERR) {
+		socklen_t len(sizeof(error));
+		if(getsockopt(pSocket->id(), SOL_SOCKET, SO_ERROR, (void *)&error, &len)==-1)
+			error = Net::LastError();
+		if (pSocket->_zeroCopy)
+			pSocket->zeroCopied(); // zero-copy completions are signaled on the error queue (without socket error)
+	}
+	if (events&EPOLLRDHUP) {
+		// disconnection
+		close(pSocket, error);
+		return;
+	}
+	if (!(events&EPOLLHUP)) { // if socket unexpected close no more read or write!
+		// EPOLLOUT in first to get the onFlush (onConnection for TCP) in first (before any reception)
+		if (events&EPOLLOUT) {
+			write(pSocket, error);
+			error = 0;
+		}
+		if (events&EPOLLIN) {
+			read(pSocket, error);
+			error = 0;
+		}
+	}
+	if (error) // on few unix system we can get an error without anything else
+		threadPool.queue<Action>(pSocket->_threadReceive, "SocketError", error, pSocket);
+}
+#endif
+
+void IOSocket::send(Socket& socket) {
+#if defined(URING_NET_API)
+	lock_guard<mutex> lock(_mutexRing);
+	if (_pRing && socket._pWeakThis)
+		_pRing->post((Ring::Subscription*)socket._pWeakThis, Ring::REQUEST_SEND, socket._weakSocket.lock());
+#endif
+}
+
 void IOSocket::stop() {
+	for (unique<IOSocket>& pShard : _shards)
+		pShard->stop();
 #if defined(SRT_API)
 	if (_pIOSRTSocket)
 		_pIOSRTSocket->stop();
@@ -16,6 +16,7 @@ details (or else see http://mozilla.org/MPL/2.0/).
 
 #include "Mona/Logs.h"
 #include "Mona/Util.h"
+#include <algorithm>
 
 using namespace std;
 
@@ -28,14 +29,192 @@ thread_local bool		Logs::_Dumping(false);
 thread_local bool		Logs::_Logging(false);
 
 volatile bool			Logs::_Dump;
+mutex					Logs::_DumpMutex;
 std::string				Logs::_DumpFilter;
-Int32					Logs::_DumpLimit(-1);
+atomic<UInt32>			Logs::_DumpVersion(0);
+atomic<Int32>			Logs::_DumpLimit(-1);
 volatile bool			Logs::_DumpRequest(true);
 volatile bool			Logs::_DumpResponse(true);
 
+struct Logs::Ring : virtual Object {
+	struct Slot {
+		LOG_LEVEL	level;
+		Int64		time; // emission time
+		const char*	file;
+		long		line;
+		string		message; // capacity reused from one log to the next
+	};
+	Ring(UInt32 capacity) : threadId(Thread::CurrentId()), reserving(false), _slots(capacity), _mask(capacity - 1), _head(0), _tail(0) {}
+
+	const UInt32 threadId;
+	/*!
+	Set by the producer before to check that asynchronous logs are still on, and reset on commit,
+	SetAsync(0) waits it to be false before its last drain */
+	atomic<bool> reserving;
+
+	/*!
+	Producer side, returns NULL if full */
+	string* reserve() {
+		UInt32 tail(_tail.load(memory_order_relaxed));
+		return (tail - _head.load(memory_order_acquire)) > _mask ? NULL : &_slots[tail & _mask].message;
+	}
+	/*!
+	Producer side, returns true when ring is half full to wake up the drainer */
+	bool commit(LOG_LEVEL level, const char* file, long line) {
+		UInt32 tail(_tail.load(memory_order_relaxed));
+		Slot& slot(_slots[tail & _mask]);
+		slot.level = level;
+		slot.time = Time::Now();
+		slot.file = file;
+		slot.line = line;
+		_tail.store(++tail, memory_order_release);
+		reserving.store(false, memory_order_release);
+		return (tail - _head.load(memory_order_relaxed)) > (_mask >> 1);
+	}
+	/*!
+	Consumer side, returns NULL if empty */
+	Slot* front() {
+		UInt32 head(_head.load(memory_order_relaxed));
+		return head == _tail.load(memory_order_acquire) ? NULL : &_slots[head & _mask];
+	}
+	void pop() { _head.store(_head.load(memory_order_relaxed) + 1, memory_order_release); }
+
+private:
+	vector<Slot>	_slots;
+	const UInt32	_mask;
+	atomic<UInt32>	_head;
+	atomic<UInt32>	_tail;
+};
+
+struct Logs::Drainer : Thread {
+	Drainer() : Thread("Logs"), _dropped(0) {}
+	~Drainer() { stop(); }
+
+	void add(const shared<Ring>& pRing) {
+		lock_guard<mutex> lock(_addMutex);
+		_added.emplace_back(pRing);
+	}
+	void awake() { wakeUp.set(); }
+	/*!
+	Wait the end of the reservations in progress, asynchronous logs must be stopped */
+	void settle() {
+		lock_guard<mutex> lockRings(_mutex);
+		lock_guard<mutex> lock(_addMutex); // a ring added after sees _AsyncCapacity at 0
+		for (const shared<Ring>& pRing : _rings) {
+			while (pRing->reserving)
+				this_thread::yield();
+		}
+		for (const shared<Ring>& pRing : _added) {
+			while (pRing->reserving)
+				this_thread::yield();
+		}
+	}
+
+	/*!
+	Pop the slots of the rings in a batch under the rings lock, then write it under the loggers lock (_Mutex)
+	without holding the rings. The loggers lock is taken before to release the rings one to keep the order
+	between two drains, and no asynchronous log or dump takes one or the other */
+	void drain() {
+		struct Log : Ring::Slot {
+			UInt32 threadId;
+		};
+		thread_local vector<Log> Batch; // keeps its message capacities from one drain to the next
+		UInt32 count(0);
+		unique_lock<mutex> lockRings(_mutex);
+		if (!_added.empty()) {
+			lock_guard<mutex> lock(_addMutex);
+			for (shared<Ring>& pRing : _added)
+				_rings.emplace_back(move(pRing));
+			_added.clear();
+		}
+		auto it = _rings.begin();
+		while (it != _rings.end()) {
+			bool orphan(it->unique()); // thread ended, ring can't be filled anymore
+			Ring& ring(**it);
+			while (Ring::Slot* pSlot = ring.front()) {
+				if (count == Batch.size())
+					Batch.emplace_back();
+				Log& log(Batch[count++]);
+				log.level = pSlot->level;
+				log.time = pSlot->time;
+				log.file = pSlot->file;
+				log.line = pSlot->line;
+				log.threadId = ring.threadId;
+				log.message.swap(pSlot->message); // no copy, the ring gets back a previous message of the batch
+				ring.pop();
+			}
+			if (orphan)
+				it = _rings.erase(it);
+			else
+				++it;
+		}
+		UInt64 dropped(_Dropped);
+		dropped -= _dropped;
+		_dropped += dropped;
+		if (!count && !dropped)
+			return;
+
+		lock_guard<mutex> lock(_Mutex);
+		lockRings.unlock();
+		bool logging(_Logging); // can be called from a synchronous log
+		_Logging = true;
+		for (UInt32 i = 0; i < count; ++i) {
+			Log& log(Batch[i]);
+			_ThreadId = log.threadId;
+			_Time = log.time;
+			if (log.level)
+				Write(log.level, log.file, log.line, log.message, false);
+			else
+				dump(log.message, log.line);
+		}
+		_ThreadId = 0;
+		_Time = 0;
+		if (dropped) {
+			String message(dropped, " logs dropped, asynchronous log ring full");
+			Write(LOG_WARN, __FILE__, __LINE__, message, false);
+		}
+		_Loggers.flush(); // write the batch
+		_Logging = logging;
+	}
+
+private:
+	/*!
+	message is the header of line size followed by the payload */
+	void dump(string& message, long line) {
+		static string Header;
+		Header.assign(message.data(), line);
+		Dump(Header, BIN message.data() + line, UInt32(message.size() - line), false);
+		if (message.size() > 0xFF) {
+			message.resize(0xFF);
+			message.shrink_to_fit();
+		}
+	}
+
+	bool run(Exception& ex, const volatile bool& requestStop) {
+		while (!requestStop) {
+			wakeUp.wait(20);
+			drain();
+		}
+		drain(); // last drain on stop
+		return true;
+	}
+	mutex					_mutex; // protect _rings, taken only by the drains
+	vector<shared<Ring>>	_rings;
+	UInt64					_dropped;
+	mutex					_addMutex; // protect _added, taken by a thread on its first asynchronous log
+	vector<shared<Ring>>	_added;
+};
+
 atomic<LOG_LEVEL>		Logs::_Level(LOG_DEFAULT); // default log level
 Logs::Loggers			Logs::_Loggers;
 
+atomic<UInt32>			Logs::_AsyncCapacity(0);
+atomic<UInt64>			Logs::_Dropped(0);
+thread_local UInt32		Logs::_ThreadId(0);
+thread_local Int64		Logs::_Time(0);
+thread_local shared<Logs::Ring> Logs::_PRing;
+Logs::Drainer			Logs::_Drainer; // after _Loggers to be stopped (last drain) before their deletion
+
 std::string				Logs::_Critic;
 
 Logs::Disable::Disable(bool log, bool dump) : _logging(_Logging), _dumping(_Dumping) {
@@ -58,46 +237,157 @@ bool Logs::LastCritic(string& critic) {
 }
 
 const char* Logs::GetDump() {
-	if (!_Dump)
-		return NULL;
-	thread_local string DumpFilter;
-	lock_guard<mutex> lock(_Mutex);
-	return (DumpFilter = _DumpFilter).c_str();
+	return _Dump ? DumpFilter().c_str() : NULL;
+}
+
+const string& Logs::DumpFilter() {
+	thread_local string Filter;
+	thread_local UInt32 Version(0);
+	UInt32 version(_DumpVersion.load(memory_order_acquire));
+	if (version != Version) {
+		lock_guard<mutex> lock(_DumpMutex);
+		Filter = _DumpFilter;
+		Version = _DumpVersion; // version of this copy, maybe newer than version
+	}
+	return Filter;
 }
 
 void Logs::SetDump(const char* name) {
-	lock_guard<mutex> lock(_Mutex);
+	lock_guard<mutex> lock(_DumpMutex);
 	_DumpResponse = _DumpRequest = true;
 	if (!name) {
 		_Dump = false;
 		_DumpFilter.clear();
 		_DumpFilter.shrink_to_fit();
-		return;
+	} else {
+		_Dump = true;
+		_DumpFilter = name;
+		char last(_DumpFilter.empty() ? 0 : _DumpFilter.back());
+		if (last == '>') {
+			_DumpRequest = false;
+			_DumpFilter.pop_back();
+		} else if (last == '<') {
+			_DumpResponse = false;
+			_DumpFilter.pop_back();
+		}
 	}
-	_Dump = true;
-	_DumpFilter = name;
-	if (_DumpFilter.empty())
+	_DumpVersion.fetch_add(1, memory_order_release);
+}
+
+void Logs::SetAsync(UInt32 capacity) {
+	if (!capacity) {
+		_AsyncCapacity = 0;
+		_Drainer.stop();
+		_Drainer.settle(); // reservations which have seen _AsyncCapacity before 0
+		_Drainer.drain(); // logs committed during the stop
 		return;
-	if (_DumpFilter.back() == '>') {
-		_DumpRequest = false;
-		_DumpFilter.pop_back();
-	} else if (_DumpFilter.back() == '<') {
-		_DumpResponse = false;
-		_DumpFilter.pop_back();
 	}
+	UInt32 power(1);
+	while (power < capacity && power < 0x80000000)
+		power <<= 1;
+	_AsyncCapacity = power; // for the rings to come, a thread keeps its ring
+	_Drainer.start();
+}
+
+string* Logs::Reserve(bool& full) {
+	if (!_PRing) {
+		UInt32 capacity(_AsyncCapacity); // read once, can become 0 meanwhile
+		if (!capacity)
+			return NULL;
+		_PRing.set(capacity);
+		_Drainer.add(_PRing);
+	}
+	Ring& ring(*_PRing);
+	ring.reserving = true; // before to check _AsyncCapacity, SetAsync(0) sets _AsyncCapacity before to check reserving
+	if (!_AsyncCapacity) {
+		ring.reserving = false;
+		return NULL;
+	}
+	string* pMessage = ring.reserve();
+	if (!pMessage) {
+		ring.reserving = false;
+		full = true;
+		++_Dropped;
+	}
+	return pMessage;
+}
+
+void Logs::Commit(LOG_LEVEL level, const char* file, long line) {
+	if (_PRing->commit(level, file, line))
+		_Drainer.awake();
+}
+
+void Logs::CommitDump(const UInt8* data, UInt32 size) {
+	Int32 limit(_DumpLimit);
+	if (limit >= 0 && size > UInt32(limit))
+		size = limit;
+	string& message(*_PRing->reserve()); // the header
+	long headerSize(long(message.size()));
+	message.append(STR data, size);
+	if (_PRing->commit(0, "", headerSize)) // level 0 for a dump, line is the header size
+		_Drainer.awake();
+}
+
+bool Logs::Filtered(const char* name) {
+	const string& filter(DumpFilter());
+	return filter.empty() || String::ICompare(filter, name) == 0;
+}
+
+void Logs::Drain() {
+	_Drainer.drain();
+}
+
+void Logs::Write(LOG_LEVEL level, const char* file, long line, string& message, bool flush) {
+	static Path File;
+	File.set(file);
+	if (level <= LOG_CRITIC)
+		_Critic.assign(message.empty() ? "unknown" : message.c_str());
+	for (auto& it : _Loggers) {
+		if (*it.second && !it.second->log(level, File, line, message))
+			_Loggers.fail(*it.second);
+	}
+	if (message.size() > 0xFF) {
+		message.resize(0xFF);
+		message.shrink_to_fit();
+	}
+	if (flush)
+		_Loggers.flush();
 }
 
-void Logs::Dump(const string& header, const UInt8* data, UInt32 size) {
-	Buffer out;
-	Util::Dump(data, (_DumpLimit<0 || size<UInt32(_DumpLimit)) ? size : _DumpLimit, out);
+void Logs::Dump(const string& header, const UInt8* data, UInt32 size, bool flush) {
+	Int32 limit(_DumpLimit);
+	if (limit >= 0 && size > UInt32(limit))
+		size = limit;
+	bool binary(false);
 	for (auto& it : _Loggers) {
-		if (*it.second && !it.second->dump(header, out.data(), out.size()))
+		if (!*it.second || !it.second->binary())
+			continue;
+		binary = true;
+		if (!it.second->dump(header, data, size))
 			_Loggers.fail(*it.second);
 	}
-	_Loggers.flush();
+	if (!binary) {
+		Buffer out;
+		Util::Dump(data, size, out);
+		for (auto& it : _Loggers) {
+			if (*it.second && !it.second->dump(header, out.data(), out.size()))
+				_Loggers.fail(*it.second);
+		}
+	}
+	if (flush)
+		_Loggers.flush();
+}
+
+void Logs::Loggers::fail(Logger& logger) {
+	if (std::find(_failed.begin(), _failed.end(), &logger) == _failed.end()) // once, log and flush can fail both
+		_failed.emplace_back(&logger);
 }
 
 void Logs::Loggers::flush() {
+	for (auto& it : self) {
+		if (*it.second && !it.second->flush())
+			fail(*it.second);
+	}
 	while (!_failed.empty()) {
 		Logger& logger(*_failed.front());
 		String message(logger.name, " log has failed");
@@ -59,8 +59,8 @@ Packet Packet::operator-(UInt32 count) const {
 
 const shared<const Binary>& Packet::bufferize() const {
 	if (_data && !*_ppBuffer) { // if has data, and _ppBuffer is empty (no bufferized) => bufferize!
-		_reference = false;
-		_ppBuffer = new shared<const Binary>(shared<Buffer>(SET, _data, _size));
+		_ppBuffer = new Holder(shared<Buffer>(SET, _data, _size));
+		_reference = false; // was a reference, a captured buffer is never empty
 		_data = (*_ppBuffer)->data(); // fix new data address
 	}
 	return *_ppBuffer;
@@ -69,11 +69,14 @@ const shared<const Binary>& Packet::bufferize() const {
 Packet& Packet::set(const Packet&& packet) {
 	if (!packet.data()) // if size==0 the normal behavior is required to get the same data address
 		return set(NULL, 0);
+	packet.bufferize();
+	// share the holder of packet, or capture its referenced buffer
+	Holder* pHolder = packet._reference ? new Holder(*packet._ppBuffer) : ((Holder*)packet._ppBuffer)->share();
 	if (!_reference)
-		delete _ppBuffer;
+		((Holder*)_ppBuffer)->release();
 	else
 		_reference = false;
-	_ppBuffer = new shared<const Binary>(packet.bufferize());
+	_ppBuffer = pHolder;
 	_data = packet._data;
 	_size = packet._size;
 	return self;
@@ -85,7 +88,7 @@ Packet& Packet::set(const Packet& packet) {
 	if (!_reference) {
 		if (packet._ppBuffer == _ppBuffer)
 			return self; // packet is a reference to thi, change just data aera!
-		delete _ppBuffer;
+		((Holder*)_ppBuffer)->release();
 		_reference = true;
 	}
 	_ppBuffer = packet._ppBuffer;
@@ -94,7 +97,7 @@ Packet& Packet::set(const Packet& packet) {
 
 Packet& Packet::set(const void* data, UInt32 size) {
 	if (!_reference) {
-		delete _ppBuffer;
+		((Holder*)_ppBuffer)->release();
 		_reference = true;
 	}
 	_ppBuffer = &Null().buffer();
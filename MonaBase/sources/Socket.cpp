@@ -16,9 +16,16 @@ details (or else see http://mozilla.org/MPL/2.0/).
 
 
 #include "Mona/Socket.h"
+#include "Mona/IOSocket.h"
+#include "Mona/File.h"
 #if !defined(_WIN32)
 #include <net/if.h>
 #include <fcntl.h>
+#include <netinet/udp.h>
+#if !defined(_BSD)
+#include <sys/sendfile.h>
+#include <linux/errqueue.h>
+#endif
 #endif
 
 
@@ -30,7 +37,7 @@ Socket::Socket(Type type) :
 #if !defined(_WIN32)
 	_pWeakThis(NULL), 
 #endif
-	_opened(false), _pDecoder(NULL), _externDecoder(false), _nonBlockingMode(false), _listening(false), _receiving(0), _queueing(0), _recvBufferSize(Net::GetRecvBufferSize()), _sendBufferSize(Net::GetSendBufferSize()), _reading(0), _sending(false), type(type), _recvTime(0), _sendTime(0), _id(NET_INVALID_SOCKET), _threadReceive(0),
+	_opened(false), _pDecoder(NULL), _externDecoder(false), _nonBlockingMode(false), _listening(false), _receiving(0), _queueing(0), _recvBufferSize(Net::GetRecvBufferSize()), _sendBufferSize(Net::GetSendBufferSize()), _reading(0), _sending(false), type(type), _recvTime(0), _sendTime(0), _id(NET_INVALID_SOCKET), _threadReceive(0), _recvBatches(0), _recvBatched(0), _recvSlotSize(RECV_SLOT_MIN), _recvSlotDecay(0), _recvBatchCount(1), _sendBatches(0), _sendBatched(0), _sendBatch(false), _gso(true), _zeroCopy(0), _zeroCopyId(0), _pIOSocket(NULL), _ring(false), _shutdown(false),
 	onError(_onError) {
 
 	if (type < TYPE_OTHER) {
@@ -48,7 +55,7 @@ Socket::Socket(NET_SOCKET id, const sockaddr& addr, Type type) : _peerAddress(ad
 #if !defined(_WIN32)
 	_pWeakThis(NULL),
 #endif
-	_opened(false), _pDecoder(NULL), _externDecoder(false), _nonBlockingMode(false), _listening(false), _receiving(0), _queueing(0), _recvBufferSize(Net::GetRecvBufferSize()), _sendBufferSize(Net::GetSendBufferSize()), _reading(0), _sending(false), type(type), _recvTime(Time::Now()), _sendTime(0), _id(id), _threadReceive(0),
+	_opened(false), _pDecoder(NULL), _externDecoder(false), _nonBlockingMode(false), _listening(false), _receiving(0), _queueing(0), _recvBufferSize(Net::GetRecvBufferSize()), _sendBufferSize(Net::GetSendBufferSize()), _reading(0), _sending(false), type(type), _recvTime(Time::Now()), _sendTime(0), _id(id), _threadReceive(0), _recvBatches(0), _recvBatched(0), _recvSlotSize(RECV_SLOT_MIN), _recvSlotDecay(0), _recvBatchCount(1), _sendBatches(0), _sendBatched(0), _sendBatch(false), _gso(true), _zeroCopy(0), _zeroCopyId(0), _pIOSocket(NULL), _ring(false), _shutdown(false),
 	onError(_onError) {
 
 	if (type < TYPE_OTHER)
@@ -81,6 +88,14 @@ bool Socket::shutdown(Socket::ShutdownType type) {
 	if (type) { // type = SEND or BOTH
 		Exception ignore;
 		flush(ignore);
+		if (_ring) {
+			// io_uring mode, IOSocket shutdowns the sending part after the sending in progress
+			lock_guard<mutex> lock(_mutexSending);
+			if (_sending) {
+				_shutdown = true;
+				return type == SHUTDOWN_SEND || close(SHUTDOWN_RECV);
+			}
+		}
 	}
 	return close(type);
 }
@@ -158,6 +173,11 @@ bool Socket::processParams(Exception& ex, const Parameters& parameters, const ch
 		result = setRecvBufferSize(ex, value);
 	if (processParam(parameters, "sendBufferSize", value, prefix) || (bufferSizeRead || processParam(parameters, "bufferSize", value, prefix)))
 		result = setSendBufferSize(ex, value) && result;
+	bool sendBatch;
+	if (type == TYPE_DATAGRAM && processParam(parameters, "sendBatch", sendBatch, prefix))
+		setSendBatch(sendBatch);
+	if (type == TYPE_STREAM && !isSecure() && processParam(parameters, "zeroCopy", value, prefix))
+		result = setZeroCopy(ex, value) && result;
 	return result;
 }
 
@@ -217,6 +237,67 @@ bool Socket::getReusePort() const {
 	return false;
 }
 
+bool Socket::setZeroCopy(Exception& ex, UInt32 minSize) {
+#if defined(SO_ZEROCOPY) && defined(MSG_ZEROCOPY)
+	if (type != TYPE_STREAM || isSecure()) {
+		ex.set<Ex::Unsupported>("Zero-copy sending requires a TCP socket without TLS");
+		return false;
+	}
+	if (minSize && _ring) {
+		ex.set<Ex::Unsupported>("Zero-copy sending unsupported by a socket sending with io_uring");
+		return false;
+	}
+	if (minSize && !_zeroCopy && !setOption(ex, SOL_SOCKET, SO_ZEROCOPY, 1))
+		return false;
+	_zeroCopy = minSize;
+	return true;
+#else
+	ex.set<Ex::Unsupported>("Zero-copy sending unsupported on this platform");
+	return false;
+#endif
+}
+
+int Socket::sendZeroCopy(Exception& ex, const Packet& packet, int flags) {
+#if defined(SO_ZEROCOPY) && defined(MSG_ZEROCOPY)
+	// hold the packet (bufferized if not already) to keep its memory untouched until the kernel has sent it
+	_zeroCopies.emplace_back(std::move(packet));
+	int sent = sendTo(ex, _zeroCopies.back().data(), _zeroCopies.back().size(), SocketAddress::Wildcard(), flags | MSG_ZEROCOPY);
+	if (sent > 0)
+		return sent; // kernel has given to this sending the next completion id
+	_zeroCopies.pop_back(); // nothing sent, no completion
+	return sent;
+#else
+	return sendTo(ex, packet.data(), packet.size(), SocketAddress::Wildcard(), flags);
+#endif
+}
+
+void Socket::zeroCopied() {
+#if defined(SO_ZEROCOPY) && defined(MSG_ZEROCOPY)
+	char control[128];
+	msghdr msg;
+	memset(&msg, 0, sizeof(msg));
+	lock_guard<mutex> lock(_mutexSending);
+	for (;;) {
+		msg.msg_control = control;
+		msg.msg_controllen = sizeof(control);
+		if (::recvmsg(_id, &msg, MSG_ERRQUEUE | MSG_DONTWAIT) < 0)
+			return; // error queue empty (edge-triggered, read until EAGAIN)
+		for (cmsghdr* pCMsg = CMSG_FIRSTHDR(&msg); pCMsg; pCMsg = CMSG_NXTHDR(&msg, pCMsg)) {
+			if ((pCMsg->cmsg_level != SOL_IP || pCMsg->cmsg_type != IP_RECVERR) && (pCMsg->cmsg_level != SOL_IPV6 || pCMsg->cmsg_type != IPV6_RECVERR))
+				continue;
+			const sock_extended_err* pError = (const sock_extended_err*)CMSG_DATA(pCMsg);
+			if (pError->ee_errno || pError->ee_origin != SO_EE_ORIGIN_ZEROCOPY)
+				continue;
+			// [ee_info, ee_data] range of ids completed, TCP completes in order
+			while (!_zeroCopies.empty() && Int32(pError->ee_data - _zeroCopyId) >= 0) {
+				_zeroCopies.pop_front();
+				++_zeroCopyId;
+			}
+		}
+	}
+#endif
+}
+
 bool Socket::joinGroup(Exception& ex, const IPAddress& ip, UInt32 interfaceIndex) {
 	if (ip.family() == IPAddress::IPv4) {
 		struct ip_mreq mreq;
@@ -442,6 +523,110 @@ int Socket::receive(Exception& ex, void* buffer, UInt32 size, int flags, SocketA
 	return rc;
 }
 
+int Socket::receive(Exception& ex, shared<Buffer>* pBuffers, SocketAddress* addresses, UInt32 count) {
+	if (_ex) {
+		ex = _ex;
+		return -1;
+	}
+	if (count > RECV_BATCH_MAX)
+		count = RECV_BATCH_MAX;
+	if (count > _recvBatchCount)
+		count = _recvBatchCount; // slots allocated only for the datagrams likely waiting
+	int rc;
+#if defined(MSG_WAITFORONE) // recvmmsg supported
+	if (type == TYPE_DATAGRAM && count > 1 && !isSecure()) {
+		union Address {
+			struct sockaddr_in  sa_in;
+			struct sockaddr_in6 sa_in6;
+		} addrs[RECV_BATCH_MAX];
+		struct iovec	iovecs[RECV_BATCH_MAX][2];
+		struct mmsghdr	msgs[RECV_BATCH_MAX];
+		memset(msgs, 0, count * sizeof(mmsghdr));
+		UInt32 slotSize(_recvSlotSize);
+		// each slot continues in its spill area to never truncate a datagram bigger than slot size,
+		// shared by the sockets received on the same thread (data copied before return), and allocated
+		// without initialization its pages are committed by the system only when written
+		static thread_local std::unique_ptr<UInt8[]> PSpill;
+		if (!PSpill)
+			PSpill.reset(new UInt8[RECV_BATCH_MAX * RECV_SPILL_SIZE]);
+		for (UInt32 i = 0; i < count; ++i) {
+			BUFFER_RESET(pBuffers[i], slotSize);
+			iovecs[i][0].iov_base = pBuffers[i]->data();
+			iovecs[i][0].iov_len = slotSize;
+			iovecs[i][1].iov_base = PSpill.get() + i * RECV_SPILL_SIZE;
+			iovecs[i][1].iov_len = RECV_SPILL_SIZE;
+			msgs[i].msg_hdr.msg_iov = iovecs[i];
+			msgs[i].msg_hdr.msg_iovlen = 2;
+			msgs[i].msg_hdr.msg_name = &addrs[i];
+			msgs[i].msg_hdr.msg_namelen = sizeof(Address);
+		}
+		int error;
+		do {
+			rc = ::recvmmsg(_id, msgs, count, MSG_WAITFORONE | MSG_TRUNC, NULL); // MSG_WAITFORONE => no wait on blocking socket after the first, MSG_TRUNC => msg_len is the real datagram size
+		} while (rc < 0 && (error = Net::LastError()) == NET_EINTR);
+		if (rc < 0) {
+			_recvBatchCount = 1; // drained, the next wakeup can be for one datagram
+			SetException(error, ex, " (count=", count, ", size=", slotSize, ")");
+			return -1;
+		}
+		++_recvBatches;
+		_recvBatched += rc;
+		// batch count follows the reception rate: doubles while batches are full, else restarts from the last count
+		_recvBatchCount = UInt32(rc) < count ? rc : min(count << 1, UInt32(RECV_BATCH_MAX));
+		UInt32 bytes(0), maxSize(0);
+		int received(0);
+		for (int i = 0; i < rc; ++i) {
+			const mmsghdr& msg(msgs[i]);
+			if (msg.msg_hdr.msg_flags & MSG_TRUNC) {
+				// impossible with an UDP datagram (spill area is over its maximum payload)
+				SetException(NET_EMSGSIZE, ex, " (size=", msg.msg_len, ", slot=", slotSize, ")");
+				continue;
+			}
+			if (received != i)
+				swap(pBuffers[received], pBuffers[i]);
+			if (msg.msg_len > slotSize) {
+				// datagram continued in spill area, fit slot size to receive the next ones without copy
+				pBuffers[received]->resize(msg.msg_len, true);
+				memcpy(pBuffers[received]->data() + slotSize, PSpill.get() + i * RECV_SPILL_SIZE, msg.msg_len - slotSize);
+			} else
+				pBuffers[received]->resize(msg.msg_len, false);
+			addresses[received++].set(reinterpret_cast<const sockaddr&>(addrs[i]));
+			bytes += msg.msg_len;
+			if (msg.msg_len > maxSize)
+				maxSize = msg.msg_len;
+		}
+		// slot size follows the datagram sizes: grows at once, decays after RECV_SLOT_DECAY batches of smaller datagrams
+		if (maxSize > _recvSlotSize) {
+			_recvSlotSize = Buffer::Allocator::ComputeCapacity(maxSize);
+			_recvSlotDecay = 0;
+		} else if (_recvSlotSize <= RECV_SLOT_MIN || maxSize > (_recvSlotSize >> 1))
+			_recvSlotDecay = 0;
+		else if (++_recvSlotDecay >= RECV_SLOT_DECAY) {
+			_recvSlotSize >>= 1;
+			_recvSlotDecay = 0;
+		}
+		if (!_address)
+			_address.set(IPAddress::Loopback(), 0); // to advise that address is computable
+		receive(bytes);
+		return received;
+	}
+#endif
+	// one datagram by system call
+	UInt32 size = available();
+	if (!size) // always get something (maybe a new reception has been gotten since the last available() call)
+		size = _recvSlotSize; // in UDP allows to avoid a NET_EMSGSIZE error (where packet is lost!), and at least RECV_SLOT_MIN to be greater than max possible MTU (~1500 bytes)
+	BUFFER_RESET(pBuffers[0], size);
+	if ((rc = receive(ex, pBuffers[0]->data(), size, 0, addresses)) < 0) {
+		_recvBatchCount = 1;
+		return -1;
+	}
+	pBuffers[0]->resize(rc, false);
+	_recvBatchCount = min(count << 1, UInt32(RECV_BATCH_MAX)); // maybe more waiting, try a batch
+	++_recvBatches;
+	++_recvBatched;
+	return 1;
+}
+
 int Socket::sendTo(Exception& ex, const void* data, UInt32 size, const SocketAddress& address, int flags) {
 	if (_ex) {
 		ex = _ex;
@@ -480,13 +665,32 @@ int Socket::sendTo(Exception& ex, const void* data, UInt32 size, const SocketAdd
 
 int Socket::write(Exception& ex, const Packet& packet, const SocketAddress& address, int flags) {
 	lock_guard<mutex> lock(_mutexSending);
+	IOSocket* pIOSocket;
+	if (_ring) {
+		// io_uring mode, IOSocket sends the queue in its order on the ring (flushed on deletion once unsubscribed)
+		_sendings.emplace_back(packet, _peerAddress, flags);
+		_queueing += packet.size();
+		if (!_sending && (pIOSocket = _pIOSocket)) {
+			_sending = true;
+			pIOSocket->send(self);
+		}
+		return 0;
+	}
 	if(!_sendings.empty()) {
 		_sendings.emplace_back(packet, address ? address : _peerAddress, flags);
 		_queueing += packet.size();
 		return 0;
 	}
+	if (_sendBatch && (pIOSocket = _pIOSocket)) {
+		// batched flush mode, the packets written until the flush are sent together
+		_sending = true;
+		_sendings.emplace_back(packet, address ? address : _peerAddress, flags);
+		_queueing += packet.size();
+		pIOSocket->flush(self);
+		return 0;
+	}
 	_sending = true;
-	int	sent = sendTo(ex, packet.data(), packet.size(), address);
+	int	sent = (_zeroCopy && packet.size() >= _zeroCopy) ? sendZeroCopy(ex, packet, flags) : sendTo(ex, packet.data(), packet.size(), address);
 	if (sent < 0) {
 		int code = ex.cast<Ex::Net::Socket>().code;
 		if ((code == NET_ENOTCONN && _peerAddress) || code == NET_EWOULDBLOCK) {
@@ -510,35 +714,178 @@ int Socket::write(Exception& ex, const Packet& packet, const SocketAddress& addr
 	return sent;
 }
 
+int Socket::write(Exception& ex, const Packets& packets, const SocketAddress& address, int flags) {
+	if (packets.count() < 2)
+		return write(ex, packets ? packets.front() : Packet::Null(), address, flags);
+	if (type != TYPE_STREAM) {
+		// a chain is one datagram
+		shared<Buffer> pBuffer(SET, packets.size());
+		UInt8* data(pBuffer->data());
+		for (const Packet& packet : packets) {
+			memcpy(data, packet.data(), packet.size());
+			data += packet.size();
+		}
+		return write(ex, Packet(pBuffer), address, flags);
+	}
+	if (_zeroCopy || (isSecure() && !isKernelSecure())) {
+		// TLS records and zero-copy completions are by packet
+		int sent(0), result;
+		for (const Packet& packet : packets) {
+			if ((result = write(ex, packet, address, flags)) < 0)
+				return -1;
+			sent += result;
+		}
+		return sent;
+	}
+	lock_guard<mutex> lock(_mutexSending);
+	bool queueing(!_sendings.empty());
+	for (const Packet& packet : packets)
+		_sendings.emplace_back(packet, _peerAddress, flags);
+	_queueing += packets.size();
+	IOSocket* pIOSocket;
+	if (_ring) {
+		// io_uring mode, IOSocket sends the queue in its order on the ring (flushed on deletion once unsubscribed)
+		if (!_sending && (pIOSocket = _pIOSocket)) {
+			_sending = true;
+			pIOSocket->send(self);
+		}
+		return 0;
+	}
+	if (queueing)
+		return 0;
+	_sending = true;
+	UInt32 written(0);
+	int sent;
+	while ((sent = sendGather(ex, written)) > 0 && !_sendings.empty()); // more than SEND_GATHER_MAX packets
+	if (sent < 0) {
+		int code = ex.cast<Ex::Net::Socket>().code;
+		if ((code == NET_ENOTCONN && _peerAddress) || code == NET_EWOULDBLOCK) {
+			// stay queued and wait next call to flush(), no error!
+			ex = nullptr;
+		} else {
+			// RELIABILITY IMPOSSIBLE => shutdown system to avoid to try to send before shutdown!
+			_sendings.clear();
+			_queueing = 0;
+			close();
+			_sending = false;
+			return -1;
+		}
+	}
+	if (written && !(_queueing -= written))
+		_sending = false;
+	return written;
+}
+
+int Socket::sendFile(Exception& ex, File& file, UInt32 size) {
+#if defined(_WIN32) || defined(_BSD)
+	ex.set<Ex::Unsupported>("Zero-copy file sending unsupported on this platform");
+	return -1;
+#else
+	if (type != TYPE_STREAM || (isSecure() && !isKernelSecure())) {
+		ex.set<Ex::Unsupported>("Zero-copy file sending requires a TCP socket without TLS or with kernel TLS");
+		return -1;
+	}
+	if (_ring) {
+		ex.set<Ex::Unsupported>("Zero-copy file sending unsupported by a socket sending with io_uring");
+		return -1;
+	}
+	if (_ex) {
+		ex = _ex;
+		return -1;
+	}
+	if (!file.load(ex))
+		return -1;
+	if (file.mode) {
+		ex.set<Ex::Permission>(file.path(), " read unauthorized in writing, append or deletion mode");
+		return -1;
+	}
+	lock_guard<mutex> lock(_mutexSending);
+	if (!_sendings.empty())
+		return 0; // wait end of queueing data (onFlush)
+	_sending = true; // before sending to not miss the write event on congestion
+	ssize_t sent;
+	int error;
+	while ((sent = ::sendfile(_id, file._handle, NULL, size)) < 0 && (error = Net::LastError()) == NET_EINTR);
+	if (sent < 0) {
+		if (error == NET_EWOULDBLOCK)
+			return 0; // wait write event (onFlush)
+		close(); // shutdown system to avoid to try to send before shutdown!
+		_sending = false;
+		SetException(error, ex, " (file=", file.path(), ", size=", size, ")");
+		return -1;
+	}
+	if (!sent && size) {
+		// end of file reached before size, file truncated meanwhile (not a congestion, no write event will come)
+		close(); // response already started with the old size, shutdown to signal it to the peer
+		_sending = false;
+		ex.set<Ex::System::File>(file.path(), " truncated during sending (", size, " bytes missing)");
+		return -1;
+	}
+	file._readen += sent;
+	send(UInt32(sent));
+	if (UInt32(sent) >= size)
+		_sending = false;
+	return int(sent);
+#endif
+}
+
 bool Socket::flush(Exception& ex, bool deleting) {
 	UInt32 written(0);
 
 	unique_lock<mutex> lock(_mutexSending, defer_lock);
 	if (!deleting)
 		lock.lock();
+	IOSocket* pIOSocket;
+	if (!deleting && _ring) {
+		// io_uring mode, IOSocket sends the queue on the ring
+		if (!_sending && !_sendings.empty() && (pIOSocket = _pIOSocket)) {
+			_sending = true;
+			pIOSocket->send(self);
+		}
+		return true;
+	}
 	int sent(0);
 	while(sent>=0 && !_sendings.empty()) {
-		Sending& sending(_sendings.front());
-		sent = sendTo(ex, sending.data(), sending.size(), sending.address, sending.flags);
-		if (sent >= 0) {
-			written += sent;
-			if (UInt32(sent) < sending.size()) {
-				// can't send more!
-				sending += sent;
-				break;
-			}
+#if defined(MSG_WAITFORONE) // sendmmsg supported
+		if (type == TYPE_DATAGRAM && _sendings.size() > 1 && !isSecure()) {
+			if ((sent = sendBatch(ex, written)) >= 0)
+				continue;
+		} else
+#endif
+		if (type == TYPE_STREAM && _sendings.size() > 1 && !_zeroCopy && (!isSecure() || isKernelSecure())) {
+			if ((sent = sendGather(ex, written)) > 0)
+				continue;
+			if (!sent)
+				break; // can't send more!
 		} else {
-			int code = ex.cast<Ex::Net::Socket>().code;
-			if ((code == NET_ENOTCONN && _peerAddress) || code == NET_EWOULDBLOCK) {
-				// is connecting, can't send more now (wait onFlush)
-				ex = nullptr;
-				break;
-			} else if (type == TYPE_STREAM) {
-				// fail to send few reliable data, shutdown send!
-				close(); // shutdown system to avoid to try to send before shutdown!
-				return false;
+			Sending& sending(_sendings.front());
+			if (_zeroCopy && sending.size() >= _zeroCopy)
+				sent = sendZeroCopy(ex, sending, sending.flags);
+			else
+				sent = sendTo(ex, sending.data(), sending.size(), sending.address, sending.flags);
+			if (sent >= 0) {
+				written += sent;
+				if (UInt32(sent) < sending.size()) {
+					// can't send more!
+					sending += sent;
+					break;
+				}
+				_sendings.pop_front();
+				continue;
 			}
 		}
+		int code = ex.cast<Ex::Net::Socket>().code;
+		if ((code == NET_ENOTCONN && _peerAddress) || code == NET_EWOULDBLOCK) {
+			// is connecting, can't send more now (wait onFlush)
+			ex = nullptr;
+			break;
+		} else if (type == TYPE_STREAM) {
+			// fail to send few reliable data, shutdown send!
+			close(); // shutdown system to avoid to try to send before shutdown!
+			return false;
+		}
+		// datagram lost
+		written += _sendings.front().size();
 		_sendings.pop_front();
 	}
 	if (!deleting && written && !(_queueing -= written))
@@ -546,6 +893,166 @@ bool Socket::flush(Exception& ex, bool deleting) {
 	return true;
 }
 
+int Socket::sendGather(Exception& ex, UInt32& written) {
+	if (_ex) {
+		ex = _ex;
+		return -1;
+	}
+#if defined(_WIN32)
+	WSABUF	buffers[SEND_GATHER_MAX];
+#else
+	iovec	buffers[SEND_GATHER_MAX];
+#endif
+	int flags(_sendings.front().flags);
+	UInt32 count(0), size(0);
+	for (const Sending& sending : _sendings) {
+		if (count == SEND_GATHER_MAX || sending.flags != flags)
+			break; // sendmsg has just one flags argument for all the packets
+#if defined(_WIN32)
+		buffers[count].buf = (CHAR*)sending.data();
+		buffers[count++].len = sending.size();
+#else
+		buffers[count].iov_base = (void*)sending.data();
+		buffers[count++].iov_len = sending.size();
+#endif
+		size += sending.size();
+	}
+#if defined(MSG_NOSIGNAL)
+	flags |= MSG_NOSIGNAL;
+#endif
+	int rc;
+	int error;
+#if defined(_WIN32)
+	DWORD sent;
+	do {
+		rc = ::WSASend(_id, buffers, count, &sent, flags, NULL, NULL) ? -1 : int(sent);
+	} while (rc < 0 && (error = Net::LastError()) == NET_EINTR);
+#else
+	msghdr msg;
+	memset(&msg, 0, sizeof(msg));
+	msg.msg_iov = buffers;
+	msg.msg_iovlen = count;
+	do {
+		rc = (int)::sendmsg(_id, &msg, flags);
+	} while (rc < 0 && (error = Net::LastError()) == NET_EINTR);
+#endif
+	if (rc < 0) {
+		SetException(error, ex, " (size=", size, ", flags=", flags, ", count=", count, ")");
+		return -1;
+	}
+
+	if (!_address)
+		_address.set(IPAddress::Loopback(), 0); // to advise that address is computable
+
+	send(rc);
+	written += rc;
+	size -= rc;
+	while (rc) {
+		Sending& sending(_sendings.front());
+		if (UInt32(rc) < sending.size()) {
+			sending += rc;
+			break;
+		}
+		rc -= sending.size();
+		_sendings.pop_front();
+	}
+	return size ? 0 : count;
+}
+
+#if defined(MSG_WAITFORONE) // sendmmsg supported
+int Socket::sendBatch(Exception& ex, UInt32& written) {
+	struct iovec	iovecs[SEND_BATCH_MAX];
+	struct mmsghdr	msgs[SEND_BATCH_MAX];
+	UInt8			segments[SEND_BATCH_MAX]; // datagrams by message
+	int flags(_sendings.front().flags);
+	UInt32 count(0), datagrams(0), bytes(0);
+	const SocketAddress* pAddress(NULL);
+	for (const Sending& sending : _sendings) {
+		if (datagrams == SEND_BATCH_MAX || sending.flags != flags)
+			break; // sendmmsg has just one flags argument for all the datagrams
+		struct iovec& iovec(iovecs[datagrams++]);
+		iovec.iov_base = (void*)sending.data();
+		iovec.iov_len = sending.size();
+#if defined(UDP_SEGMENT)
+		if (count) {
+			// GSO: datagrams of same size to the same destination are gathered in one message segmented by the kernel, just the last one can be smaller
+			msghdr& msg(msgs[count - 1].msg_hdr);
+			size_t size(msg.msg_iov->iov_len);
+			if (_gso && size && *pAddress == sending.address && msg.msg_iov[msg.msg_iovlen - 1].iov_len == size && sending.size() <= size && (bytes += sending.size()) <= GSO_SIZE_MAX) {
+				++msg.msg_iovlen;
+				++segments[count - 1];
+				continue;
+			}
+		}
+		bytes = sending.size();
+#endif
+		mmsghdr& msg(msgs[count]);
+		memset(&msg, 0, sizeof(msg));
+		msg.msg_hdr.msg_iov = &iovec;
+		msg.msg_hdr.msg_iovlen = 1;
+		segments[count++] = 1;
+		pAddress = &sending.address;
+		if (!sending.address)
+			continue; // connected socket
+		msg.msg_hdr.msg_name = (void*)sending.address.data();
+		msg.msg_hdr.msg_namelen = sending.address.size();
+	}
+#if defined(UDP_SEGMENT)
+	union {
+		char	buffer[CMSG_SPACE(sizeof(UInt16))];
+		cmsghdr	align;
+	} controls[SEND_BATCH_MAX];
+	for (UInt32 i = 0; i < count; ++i) {
+		msghdr& msg(msgs[i].msg_hdr);
+		if (msg.msg_iovlen < 2)
+			continue;
+		msg.msg_control = controls[i].buffer;
+		msg.msg_controllen = sizeof(controls[i].buffer);
+		cmsghdr* pCMsg(CMSG_FIRSTHDR(&msg));
+		pCMsg->cmsg_level = IPPROTO_UDP;
+		pCMsg->cmsg_type = UDP_SEGMENT;
+		pCMsg->cmsg_len = CMSG_LEN(sizeof(UInt16));
+		*(UInt16*)CMSG_DATA(pCMsg) = UInt16(msg.msg_iov->iov_len); // segment size
+	}
+#endif
+#if defined(MSG_NOSIGNAL)
+	flags |= MSG_NOSIGNAL;
+#endif
+	int rc;
+	int error;
+	do {
+		rc = ::sendmmsg(_id, msgs, count, flags); // sends until the first message which fails
+	} while (rc < 0 && (error = Net::LastError()) == NET_EINTR);
+	if (rc < 0) {
+#if defined(UDP_SEGMENT)
+		if (segments[0] > 1 && (error == EIO || error == EINVAL || error == EOPNOTSUPP || error == ENOPROTOOPT)) {
+			// kernel or device refuses UDP_SEGMENT, fallback to one datagram by message for this socket
+			_gso = false;
+			return sendBatch(ex, written);
+		}
+#endif
+		const Sending& sending(_sendings.front());
+		SetException(error, ex, " (address=", sending.address ? sending.address : _peerAddress, ", size=", sending.size(), ", flags=", flags, ", count=", count, ")");
+		return -1;
+	}
+
+	if (!_address)
+		_address.set(IPAddress::Loopback(), 0); // to advise that address is computable
 
+	++_sendBatches;
+	bytes = datagrams = 0;
+	for (int i = 0; i < rc; ++i) {
+		bytes += msgs[i].msg_len;
+		for (UInt8 j = 0; j < segments[i]; ++j) {
+			written += _sendings.front().size();
+			_sendings.pop_front();
+		}
+		datagrams += segments[i];
+	}
+	_sendBatched += datagrams;
+	send(bytes);
+	return datagrams;
+}
+#endif
 
 } // namespace Mona
@@ -89,5 +89,19 @@ bool SocketAddress::operator < (const SocketAddress& address) const {
 	return (port() < address.port());
 }
 
+UInt32 SocketAddress::hash() const {
+	// FNV-1a on host bytes, then port and scope, finalized by a murmur3 mix to avalanche on low bits
+	UInt32 hash(2166136261u);
+	const UInt8* data(BIN host().data());
+	for (UInt8 i = 0; i < host().size(); ++i)
+		hash = (hash ^ data[i]) * 16777619u;
+	hash ^= (UInt32(port()) << 16) ^ host().scope();
+	hash ^= hash >> 16;
+	hash *= 0x85ebca6b;
+	hash ^= hash >> 13;
+	hash *= 0xc2b2ae35;
+	return hash ^ (hash >> 16);
+}
+
 
 }	// namespace Mona
@@ -56,9 +56,32 @@ bool TLS::Create(Exception& ex, const char* cert, const char* key, shared<TLS>&
 	return false;
 }
 
-TLS::Socket::Socket(Type type, const shared<TLS>& pTLS) : pTLS(pTLS), Mona::Socket(type), _ssl(NULL) {}
+bool TLS::setKernel(Exception& ex, bool enable) {
+#if defined(SSL_OP_ENABLE_KTLS) && !defined(OPENSSL_NO_KTLS)
+	if (enable)
+		SSL_CTX_set_options(_pCTX, SSL_OP_ENABLE_KTLS);
+	else
+		SSL_CTX_clear_options(_pCTX, SSL_OP_ENABLE_KTLS);
+	return true;
+#else
+	if (!enable)
+		return true;
+	ex.set<Ex::Unsupported>("Kernel TLS unsupported by this OpenSSL build");
+	return false;
+#endif
+}
+
+bool TLS::getKernel() const {
+#if defined(SSL_OP_ENABLE_KTLS) && !defined(OPENSSL_NO_KTLS)
+	return (SSL_CTX_get_options(_pCTX) & SSL_OP_ENABLE_KTLS) ? true : false;
+#else
+	return false;
+#endif
+}
+
+TLS::Socket::Socket(Type type, const shared<TLS>& pTLS) : pTLS(pTLS), Mona::Socket(type), _ssl(NULL), _kernelSecure(false) {}
 
-TLS::Socket::Socket(NET_SOCKET sockfd, const sockaddr& addr, const shared<TLS>& pTLS) : pTLS(pTLS), Mona::Socket(sockfd, addr), _ssl(NULL) {}
+TLS::Socket::Socket(NET_SOCKET sockfd, const sockaddr& addr, const shared<TLS>& pTLS) : pTLS(pTLS), Mona::Socket(sockfd, addr), _ssl(NULL), _kernelSecure(false) {}
 
 TLS::Socket::~Socket() {
 	if (!_ssl)
@@ -87,6 +110,20 @@ UInt32 TLS::Socket::available() const {
 	return SSL_pending(_ssl); // max buffer possible size (nothing to read)
 }
 
+bool TLS::Socket::isKernelSecure() const {
+#if defined(SSL_OP_ENABLE_KTLS) && !defined(OPENSSL_NO_KTLS)
+	if (_kernelSecure || !pTLS)
+		return _kernelSecure;
+	lock_guard<mutex> lock(_mutex);
+	// kTLS is set by OpenSSL at the end of the handshake and stays until the socket end
+	if (_ssl && SSL_is_init_finished(_ssl) && BIO_get_ktls_send(SSL_get_wbio(_ssl)))
+		_kernelSecure = true;
+	return _kernelSecure;
+#else
+	return false;
+#endif
+}
+
 Mona::Socket* TLS::Socket::newSocket(Exception& ex, NET_SOCKET sockfd, const sockaddr& addr) {
 	if(!pTLS)
 		return Mona::Socket::newSocket(ex, sockfd, addr); // normal socket
@@ -157,6 +194,8 @@ int TLS::Socket::receive(Exception& ex, void* buffer, UInt32 size, int flags, So
 int TLS::Socket::sendTo(Exception& ex, const void* data, UInt32 size, const SocketAddress& address, int flags) {
 	if (!pTLS)
 		return Mona::Socket::sendTo(ex, data, size, address, flags); // normal socket
+	if (isKernelSecure())
+		return Mona::Socket::sendTo(ex, data, size, address, flags); // kernel encrypts
 	lock_guard<mutex> lock(_mutex);
 	if (!_ssl)
 		return Mona::Socket::sendTo(ex, data, size, address, flags); // normal socket
@@ -24,7 +24,36 @@ namespace Mona {
 void ThreadPool::init(UInt16 threads, Thread::Priority priority) {
 	_threads.resize(_size = threads ? threads : Thread::ProcessorCount());
 	for (UInt16 i = 0; i < _size; ++i)
-		_threads[i].set(priority);
+		_threads[i].set(priority)._pPool = this;
+}
+
+ThreadPool::~ThreadPool() {
+	// stop all the threads before to delete them, a running thread can steal the others
+	join();
+}
+
+void ThreadPool::wakeIdle(UInt16 thread) const {
+	// just indicators here, the awakened thread searchs again a runner to steal
+	if (!_threads[thread]->_busy && _threads[thread]->queueing() < 2)
+		return; // will be run immediatly
+	for (UInt16 i = 1; i < _size; ++i) {
+		ThreadQueue& idle(*_threads[(thread + i) % _size]);
+		if (idle.idle())
+			return idle.wake();
+	}
+}
+
+shared<Runner> ThreadPool::steal(ThreadQueue& thief) const {
+	UInt16 start(_current);
+	for (UInt16 i = 0; i < _size; ++i) {
+		ThreadQueue& thread(*_threads[(start + i) % _size]);
+		if (&thread == &thief)
+			continue;
+		shared<Runner> pRunner(thread.steal());
+		if (pRunner)
+			return pRunner;
+	}
+	return nullptr;
 }
 
 UInt16 ThreadPool::join() {
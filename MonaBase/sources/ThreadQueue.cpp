@@ -15,6 +15,7 @@ details (or else see http://mozilla.org/MPL/2.0/).
 */
 
 #include "Mona/ThreadQueue.h"
+#include "Mona/ThreadPool.h"
 
 
 using namespace std;
@@ -31,22 +32,55 @@ bool ThreadQueue::run(Exception&, const volatile bool& requestStop) {
 		bool timeout = !wakeUp.wait(120000); // 2 mn of timeout
 		for(;;) {
 			deque<shared<Runner>> runners;
-			{
+			_runners.pop(runners); // lock-free, if runners remain the next loop will take them
+			if (!runners.empty())
+				_queueing -= runners.size();
+			else {
 				lock_guard<mutex> lock(_mutex);
-				if (_runners.empty()) {
-					if (!timeout && !requestStop)
-						break; // wait more
-					stop(); // to set _stop immediatly!
-					return true;
+				if (!_stealables.empty()) {
+					// one by one to let the rest stealable by the idle threads
+					runners.emplace_back(move(_stealables.front()));
+					_stealables.pop_front();
+					--_queueing;
 				}
-				runners = move(_runners);
+			}
+			_busy = !runners.empty();
+			if (runners.empty() && _pPool) {
+				// nothing to do, try to steal an other thread
+				shared<Runner> pRunner(_pPool->steal(self));
+				if (pRunner) {
+					_busy = true;
+					++_steals;
+					runners.emplace_back(move(pRunner));
+				}
+			}
+			if (runners.empty()) {
+				lock_guard<mutex> lock(_mutex);
+				// _runners.count() <= 0 => the next push returns true and queue will restart the thread after this mutex
+				if (_runners.count() > 0 || !_stealables.empty())
+					continue;
+				if (!timeout && !requestStop)
+					break; // wait more
+				stop(); // to set _stop immediatly!
+				return true;
 			}
 			for (shared<Runner>& pRunner : runners) {
 				pRunner->run(pRunner->name);
 				pRunner.reset(); // release resources
 			}
+			_busy = false;
 		}
 	}
 }
 
+shared<Runner> ThreadQueue::steal() {
+	unique_lock<mutex> lock(_mutex, try_to_lock);
+	if (!lock || _stealables.empty())
+		return nullptr;
+	shared<Runner> pRunner(move(_stealables.front()));
+	_stealables.pop_front();
+	--_queueing;
+	return pRunner;
+}
+
 } // namespace Mona
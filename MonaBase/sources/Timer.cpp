@@ -22,75 +22,128 @@ using namespace std;
 
 namespace Mona {
 
+Timer::Timer() : _count(0), _tick(0), _pRaising(NULL) {
+	memset(_slots, 0, sizeof(_slots));
+}
+
 Timer::~Timer() {
-	for(const auto& it : _timers) {
-		for (const OnTimer* pTimer : *it.second)
-			pTimer->_nextRaising = 0;
+	for (auto& slots : _slots) {
+		for (const OnTimer* pTimer : slots) {
+			for (; pTimer; pTimer = pTimer->_pNext)
+				pTimer->_nextRaising = 0;
+		}
 	}
 }
 
 const Timer::OnTimer& Timer::set(const OnTimer& onTimer,  UInt32 timeout) const {
-	shared<std::set<const OnTimer*>> pMove;
-	if (!remove(onTimer, pMove)) {
-		add(onTimer, timeout);
+	if (onTimer._nextRaising)
+		remove(onTimer);
+	if (!timeout)
 		return onTimer;
-	}
-	if (timeout) {
-		// MOVE (more efficient!)
-		++_count;
-		const auto& it = _timers.emplace(onTimer._nextRaising = Time::Now() + timeout, move(pMove));
-		if (!it.second)
-			it.first->second->emplace(&onTimer);
-		 else if (!it.first->second)
-			 it.first->second.set().emplace(&onTimer);
-	}
+	Int64 now(Time::Now());
+	if (!_count++)
+		_tick = now; // empty wheel, can restart from now
+	onTimer._nextRaising = now + timeout;
+	add(onTimer);
 	return onTimer;
 }
 
-void Timer::add(const OnTimer& onTimer,  UInt32 timeout) const {
-	if (!timeout)
-		return;
-	++_count;
-	auto& it(_timers[(onTimer._nextRaising=Time::Now() + timeout)]);
-	if (!it)
-		it.set();
-	it->emplace(&onTimer);
+void Timer::add(const OnTimer& onTimer) const {
+	// in the past => next tick
+	UInt64 tick = max(Int64(onTimer._nextRaising), Int64(_tick));
+	UInt64 delta = tick - _tick;
+	UInt8 level(0);
+	while (level < (LEVELS - 1) && (delta >> (SLOT_BITS * (level + 1))))
+		++level;
+	if (delta >> (SLOT_BITS * LEVELS))
+		tick = _tick + (1ull << (SLOT_BITS * LEVELS)) - 1; // out of wheel (raise late), will be placed again on cascade
+	const OnTimer** ppSlot = &_slots[level][(tick >> (SLOT_BITS * level)) & (SLOTS - 1)];
+	onTimer._ppSlot = ppSlot;
+	onTimer._pPrev = NULL;
+	if ((onTimer._pNext = *ppSlot))
+		onTimer._pNext->_pPrev = &onTimer;
+	*ppSlot = &onTimer;
 }
 
-bool Timer::remove(const OnTimer& onTimer, shared<std::set<const OnTimer*>>& pMove) const {
-	if (!onTimer._nextRaising)
-		return false;
-	const auto& it(_timers.find(onTimer._nextRaising));
-	if (it != _timers.end()) {
-		onTimer._nextRaising = 0;
-		--_count;
-		if (it->second->size() == 1) {
-			if(*it->second->begin() == &onTimer) {
-				pMove = move(it->second);
-				_timers.erase(it);
-				return true;
+void Timer::remove(const OnTimer& onTimer) const {
+	if (onTimer._ppSlot != &_pRaising && (onTimer._ppSlot < &_slots[0][0] || onTimer._ppSlot > &_slots[LEVELS - 1][SLOTS - 1]))
+		FATAL_ERROR("Timer already used on an other Timer machine, create both individual Timer::Type rather");
+	if (onTimer._pPrev)
+		onTimer._pPrev->_pNext = onTimer._pNext;
+	else
+		*onTimer._ppSlot = onTimer._pNext;
+	if (onTimer._pNext)
+		onTimer._pNext->_pPrev = onTimer._pPrev;
+	onTimer._pPrev = onTimer._pNext = NULL;
+	onTimer._ppSlot = NULL;
+	onTimer._nextRaising = 0;
+	--_count;
+}
+
+UInt64 Timer::next() const {
+	UInt64 tick(-1);
+	// level 0 => exact expiration
+	for (UInt16 i = 0; i < SLOTS; ++i) {
+		if (_slots[0][(_tick + i) & (SLOTS - 1)]) {
+			tick = _tick + i;
+			break;
+		}
+	}
+	// upper levels => cascade time (if before)
+	for (UInt8 level = 1; level < LEVELS; ++level) {
+		UInt8 shift(SLOT_BITS * level);
+		UInt64 block((_tick + (1ull << shift) - 1) >> shift);
+		for (UInt16 i = 0; i < SLOTS && (block << shift) < tick; ++i, ++block) {
+			if (_slots[level][block & (SLOTS - 1)]) {
+				tick = block << shift;
+				break;
 			}
-		} else if(it->second->erase(&onTimer))
-			return true;
+		}
+	}
+	return tick;
+}
+
+void Timer::cascade(UInt8 level, UInt8 index) {
+	const OnTimer* pTimer = _slots[level][index];
+	_slots[level][index] = NULL;
+	while (pTimer) {
+		const OnTimer* pNext = pTimer->_pNext;
+		add(*pTimer);
+		pTimer = pNext;
 	}
-	FATAL_ERROR("Timer already used on an other Timer machine, create both individual Timer::Type rather");
-	return false;
 }
 
 UInt32 Timer::raise() {
-	while (!_timers.empty()) {
-		const auto& it(_timers.begin());
-		Int64 waiting(it->first-Time::Now());
-		if (waiting>0)
-			return UInt32(waiting); // > 0!
-		auto itTimers(move(it->second));
-		_timers.erase(it);
-		for (const OnTimer* pTimer : *itTimers) {
+	while (_count) {
+		UInt64 tick(next());
+		Int64 now(Time::Now());
+		if (Int64(tick) > now)
+			return UInt32(min<UInt64>(tick - now, 0xFFFFFFFF)); // > 0!
+		_tick = tick;
+		// cascade upper levels when lower index is 0
+		UInt8 index(tick & (SLOTS - 1));
+		for (UInt8 level = 1; !index && level < LEVELS; ++level)
+			cascade(level, index = (tick >> (SLOT_BITS * level)) & (SLOTS - 1));
+		++_tick;
+		// detach the slot, a timer re-armed on 256 ms could come back in this same slot
+		const OnTimer** ppSlot(&_slots[0][tick & (SLOTS - 1)]);
+		if (!(_pRaising = *ppSlot))
+			continue;
+		*ppSlot = NULL;
+		const OnTimer* pTimer;
+		for (pTimer = _pRaising; pTimer; pTimer = pTimer->_pNext)
+			pTimer->_ppSlot = &_pRaising;
+		while ((pTimer = _pRaising)) {
+			if ((_pRaising = pTimer->_pNext))
+				_pRaising->_pPrev = NULL;
+			pTimer->_pNext = NULL;
+			pTimer->_ppSlot = NULL;
+			UInt32 delay(UInt32(max<Int64>(now - pTimer->_nextRaising, 0)));
 			pTimer->_nextRaising = 0;
-			UInt32 timeout = (*pTimer)(UInt32(-waiting));
+			UInt32 timeout = (*pTimer)(delay);
 			--_count;
-			if(timeout)
-				add(*pTimer, timeout);
+			if (timeout)
+				set(*pTimer, timeout);
 		}
 	}
 	return 0; //empty!
@@ -0,0 +1,130 @@
+/*
+This file is a part of MonaSolutions Copyright 2017
+mathieu.poux[a]gmail.com
+jammetthomas[a]gmail.com
+
+This program is free software: you can redistribute it and/or
+modify it under the terms of the the Mozilla Public License v2.0.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+Mozilla Public License v. 2.0 received along this program for more
+details (or else see http://mozilla.org/MPL/2.0/).
+
+*/
+
+#include "Mona/TraceLogger.h"
+#include "Mona/Logs.h"
+
+
+using namespace std;
+
+namespace Mona {
+
+TraceLogger::TraceLogger(string&& dir, UInt32 sizeByFile, UInt16 rotation) : FileLogger(move(dir), sizeByFile, rotation, "trace") {
+}
+
+TraceLogger::~TraceLogger() {
+	flush();
+}
+
+BinaryWriter& TraceLogger::begin(BinaryWriter& writer) {
+	if (!written() && !_buffer.size()) // new file
+		writer.write(EXPAND("MTRC")).write8(VERSION);
+	return writer;
+}
+
+bool TraceLogger::log(LOG_LEVEL level, const Path& file, long line, const string& message) {
+	BinaryWriter writer(_buffer);
+	begin(writer);
+	const auto& it = _files.emplace(file, UInt16(_files.size()));
+	if (it.second)
+		writer.write8(TYPE_FILE).write16(it.first->second).writeString(file);
+	writer.write8(TYPE_LOG).write64(Logs::Now()).write32(Logs::ThreadId()).write8(level).write16(it.first->second).write32(UInt32(line)).writeString(message);
+	return _buffer.size() < BATCH_SIZE || flush();
+}
+
+bool TraceLogger::dump(const string& header, const UInt8* data, UInt32 size) {
+	BinaryWriter writer(_buffer);
+	begin(writer).write8(TYPE_DUMP).write64(Logs::Now()).write32(Logs::ThreadId()).writeString(header).write7Bit<UInt32>(size).write(data, size);
+	return _buffer.size() < BATCH_SIZE || flush();
+}
+
+bool TraceLogger::flush() {
+	if (!_buffer.size())
+		return true;
+	bool success(write(_buffer.data(), _buffer.size()));
+	_buffer.clear();
+	return success;
+}
+
+bool TraceLogger::Reader::read(Record& record) {
+	while (_reader.available()) {
+		UInt8 type = _reader.read8();
+		switch (type) {
+			case 'M': // file header, can be repeated on concatenated files
+				if (_reader.available() < 4 || memcmp(_reader.current(), "TRC", 3) != 0 || _reader.current()[3] != VERSION)
+					break;
+				_reader.next(4);
+				_files.clear();
+				continue;
+			case TYPE_FILE: {
+				if (_reader.available() < 2)
+					break;
+				UInt16 id = _reader.read16();
+				if (!readString(_files[id]))
+					break;
+				continue;
+			}
+			case TYPE_LOG: {
+				if (_reader.available() < 20)
+					break;
+				record.type = TYPE_LOG;
+				record.time = _reader.read64();
+				record.threadId = _reader.read32();
+				record.level = _reader.read8();
+				const auto& it = _files.find(_reader.read16());
+				record.file = it == _files.end() ? "?" : it->second.c_str();
+				record.line = _reader.read32();
+				if (!readString(record.text))
+					break;
+				record.data = NULL;
+				record.size = 0;
+				return true;
+			}
+			case TYPE_DUMP:
+				if (_reader.available() < 12)
+					break;
+				record.type = TYPE_DUMP;
+				record.time = _reader.read64();
+				record.threadId = _reader.read32();
+				record.level = 0;
+				record.file = "";
+				record.line = 0;
+				if (!readString(record.text))
+					break;
+				record.size = _reader.read7Bit<UInt32>();
+				if (record.size > _reader.available())
+					break;
+				record.data = _reader.current();
+				_reader.next(record.size);
+				return true;
+			default:;
+		}
+		_corrupted = true;
+		break;
+	}
+	return false;
+}
+
+bool TraceLogger::Reader::readString(string& value) {
+	UInt32 size = _reader.read7Bit<UInt32>();
+	if (size > _reader.available())
+		return false;
+	value.assign(STR _reader.current(), size);
+	_reader.next(size);
+	return true;
+}
+
+} // namespace Mona
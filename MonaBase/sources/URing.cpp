@@ -0,0 +1,240 @@
+/*
+This file is a part of MonaSolutions Copyright 2017
+mathieu.poux[a]gmail.com
+jammetthomas[a]gmail.com
+
+This program is free software: you can redistribute it and/or
+modify it under the terms of the the Mozilla Public License v2.0.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+Mozilla Public License v. 2.0 received along this program for more
+details (or else see http://mozilla.org/MPL/2.0/).
+
+*/
+
+#include "Mona/URing.h"
+#if defined(URING_API)
+#include <unistd.h>
+#include <sys/mman.h>
+
+using namespace std;
+
+namespace Mona {
+
+URing::URing(UInt32 entries) : _fd(-1), _pSQ(MAP_FAILED), _pCQ(MAP_FAILED), _pSQEs(MAP_FAILED)
+#if defined(URING_NET_API)
+	, _pBuffers((io_uring_buf_ring*)MAP_FAILED), _buffersMask(0), _buffersTail(0)
+#endif
+	{
+	io_uring_params params;
+	memset(&params, 0, sizeof(params));
+	params.flags = IORING_SETUP_CQSIZE;
+	params.cq_entries = entries * 4; // room for a late completion thread without CQ overflow
+	if ((_fd = (int)syscall(__NR_io_uring_setup, entries, &params)) < 0)
+		return;
+	if (!(params.features & IORING_FEAT_RSRC_TAGS)) { // kernel < 5.13
+		close();
+		return;
+	}
+	_sqSize = params.sq_off.array + params.sq_entries * sizeof(UInt32);
+	_cqSize = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+	if (params.features & IORING_FEAT_SINGLE_MMAP)
+		_sqSize = _cqSize = max(_sqSize, _cqSize);
+	_pSQ = mmap(NULL, _sqSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, _fd, IORING_OFF_SQ_RING);
+	_pCQ = (params.features & IORING_FEAT_SINGLE_MMAP) ? _pSQ : mmap(NULL, _cqSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, _fd, IORING_OFF_CQ_RING);
+	_sqesSize = params.sq_entries * sizeof(io_uring_sqe);
+	_pSQEs = mmap(NULL, _sqesSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, _fd, IORING_OFF_SQES);
+	if (_pSQ == MAP_FAILED || _pCQ == MAP_FAILED || _pSQEs == MAP_FAILED) {
+		close();
+		return;
+	}
+	UInt8* pSQ((UInt8*)_pSQ);
+	_sqTail = (atomic<UInt32>*)(pSQ + params.sq_off.tail);
+	_sqQueued = _sqTail->load(memory_order_relaxed);
+	_sqEntries = params.sq_entries;
+	_sqMask = *(UInt32*)(pSQ + params.sq_off.ring_mask);
+	_sqArray = (UInt32*)(pSQ + params.sq_off.array);
+	UInt8* pCQ((UInt8*)_pCQ);
+	_cqHead = (atomic<UInt32>*)(pCQ + params.cq_off.head);
+	_cqTail = (atomic<UInt32>*)(pCQ + params.cq_off.tail);
+	_cqMask = *(UInt32*)(pCQ + params.cq_off.ring_mask);
+	_cqes = (io_uring_cqe*)(pCQ + params.cq_off.cqes);
+}
+
+void URing::close() {
+	if (_pSQEs != MAP_FAILED)
+		munmap(_pSQEs, _sqesSize);
+	if (_pCQ != MAP_FAILED && _pCQ != _pSQ)
+		munmap(_pCQ, _cqSize);
+	if (_pSQ != MAP_FAILED)
+		munmap(_pSQ, _sqSize);
+	_pSQ = _pCQ = _pSQEs = MAP_FAILED;
+	if (_fd >= 0)
+		::close(_fd);
+	_fd = -1;
+#if defined(URING_NET_API)
+	if (_pBuffers != MAP_FAILED) // after the ring closing which unregisters it
+		munmap(_pBuffers, _buffersSize);
+	_pBuffers = (io_uring_buf_ring*)MAP_FAILED;
+#endif
+}
+
+bool URing::writev(int fd, const iovec* iovs, UInt32 count, UInt64 userData, Int64 offset) {
+	io_uring_sqe sqe;
+	memset(&sqe, 0, sizeof(sqe));
+	sqe.opcode = IORING_OP_WRITEV;
+	sqe.fd = fd;
+	sqe.addr = (UInt64)iovs;
+	sqe.len = count;
+	sqe.off = (UInt64)offset;
+	sqe.user_data = userData;
+	return queue(sqe);
+}
+
+bool URing::nop(UInt64 userData) {
+	io_uring_sqe sqe;
+	memset(&sqe, 0, sizeof(sqe));
+	sqe.opcode = IORING_OP_NOP;
+	sqe.fd = -1;
+	sqe.user_data = userData;
+	return queue(sqe);
+}
+
+#if defined(URING_NET_API)
+bool URing::setBuffers(UInt16 count) {
+	if (_fd < 0 || _pBuffers != MAP_FAILED || !count || (count & (count - 1)))
+		return false;
+	_buffersSize = count * sizeof(io_uring_buf);
+	_pBuffers = (io_uring_buf_ring*)mmap(NULL, _buffersSize, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0); // page aligned
+	if (_pBuffers == MAP_FAILED)
+		return false;
+	io_uring_buf_reg reg;
+	memset(&reg, 0, sizeof(reg));
+	reg.ring_addr = (UInt64)_pBuffers;
+	reg.ring_entries = count;
+	reg.bgid = 0;
+	if (syscall(__NR_io_uring_register, _fd, IORING_REGISTER_PBUF_RING, &reg, 1) < 0) { // kernel < 5.19
+		munmap(_pBuffers, _buffersSize);
+		_pBuffers = (io_uring_buf_ring*)MAP_FAILED;
+		return false;
+	}
+	_buffersMask = count - 1;
+	_buffersTail = 0;
+	return true;
+}
+
+void URing::provide(UInt16 id, void* data, UInt32 size) {
+	// not _pBuffers->bufs, __DECLARE_FLEX_ARRAY shifts it in C++ (empty struct before the array)
+	io_uring_buf& buffer(((io_uring_buf*)_pBuffers)[_buffersTail & _buffersMask]);
+	buffer.addr = (UInt64)data;
+	buffer.len = size;
+	buffer.bid = id;
+	((atomic<UInt16>*)&_pBuffers->tail)->store(++_buffersTail, memory_order_release);
+}
+
+bool URing::poll(int fd, UInt32 events, UInt64 userData, bool multi) {
+	io_uring_sqe sqe;
+	memset(&sqe, 0, sizeof(sqe));
+	sqe.opcode = IORING_OP_POLL_ADD;
+	sqe.fd = fd;
+	sqe.poll32_events = events;
+	sqe.len = multi ? IORING_POLL_ADD_MULTI : 0;
+	sqe.user_data = userData;
+	return queue(sqe);
+}
+
+bool URing::accept(int fd, sockaddr* pAddress, socklen_t* pSize, UInt64 userData) {
+	io_uring_sqe sqe;
+	memset(&sqe, 0, sizeof(sqe));
+	sqe.opcode = IORING_OP_ACCEPT;
+	sqe.fd = fd;
+	sqe.addr = (UInt64)pAddress;
+	sqe.addr2 = (UInt64)pSize;
+	sqe.user_data = userData;
+	return queue(sqe);
+}
+
+bool URing::recv(int fd, UInt64 userData) {
+	io_uring_sqe sqe;
+	memset(&sqe, 0, sizeof(sqe));
+	sqe.opcode = IORING_OP_RECV;
+	sqe.fd = fd;
+	sqe.flags = IOSQE_BUFFER_SELECT;
+	sqe.buf_group = 0;
+	sqe.user_data = userData;
+	return queue(sqe);
+}
+
+bool URing::sendmsg(int fd, const msghdr* pMsg, int flags, UInt64 userData) {
+	io_uring_sqe sqe;
+	memset(&sqe, 0, sizeof(sqe));
+	sqe.opcode = IORING_OP_SENDMSG;
+	sqe.fd = fd;
+	sqe.addr = (UInt64)pMsg;
+	sqe.len = 1;
+	sqe.msg_flags = flags;
+	sqe.user_data = userData;
+	return queue(sqe);
+}
+
+bool URing::timeout(const __kernel_timespec* pDuration, UInt64 userData) {
+	io_uring_sqe sqe;
+	memset(&sqe, 0, sizeof(sqe));
+	sqe.opcode = IORING_OP_TIMEOUT;
+	sqe.fd = -1;
+	sqe.addr = (UInt64)pDuration;
+	sqe.len = 1;
+	sqe.user_data = userData;
+	return queue(sqe);
+}
+
+bool URing::cancel(UInt64 target, UInt64 userData) {
+	io_uring_sqe sqe;
+	memset(&sqe, 0, sizeof(sqe));
+	sqe.opcode = IORING_OP_ASYNC_CANCEL;
+	sqe.fd = -1;
+	sqe.addr = target;
+	if (!target)
+		sqe.cancel_flags = IORING_ASYNC_CANCEL_ANY | IORING_ASYNC_CANCEL_ALL;
+	sqe.user_data = userData;
+	return queue(sqe);
+}
+#endif
+
+bool URing::wait() {
+	int result;
+	while ((result = (int)syscall(__NR_io_uring_enter, _fd, 0, 1, IORING_ENTER_GETEVENTS, NULL, 0)) < 0 && errno == EINTR);
+	return result >= 0;
+}
+
+bool URing::queue(const io_uring_sqe& sqe) {
+	if (_sqQueued - _sqTail->load(memory_order_relaxed) >= _sqEntries)
+		return false;
+	UInt32 index(_sqQueued++ & _sqMask);
+	memcpy((io_uring_sqe*)_pSQEs + index, &sqe, sizeof(sqe));
+	_sqArray[index] = index;
+	return true;
+}
+
+int URing::submit() {
+	UInt32 tail(_sqTail->load(memory_order_relaxed));
+	UInt32 count(_sqQueued - tail);
+	if (!count)
+		return 0;
+	_sqTail->store(_sqQueued, memory_order_release);
+	int result;
+	while ((result = (int)syscall(__NR_io_uring_enter, _fd, count, 0, 0, NULL, 0)) < 0 && errno == EINTR);
+	if (result < 0 || UInt32(result) < count) {
+		// without SQPOLL the kernel reads the SQ only during io_uring_enter, so the entries not consumed
+		// can be withdrawn to never be submitted by a next call (caller can then release their resources)
+		_sqQueued = tail + (result > 0 ? result : 0);
+		_sqTail->store(_sqQueued, memory_order_release);
+	}
+	return result;
+}
+
+} // namespace Mona
+
+#endif
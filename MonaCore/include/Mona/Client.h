@@ -74,6 +74,9 @@ struct Client : Entity, virtual Object, Net::Stats {
 	Time						sendTime() const { return _pNetStats->sendTime(); }
 	UInt64						sendByteRate() const { return _pNetStats->sendByteRate(); }
 	double						sendLostRate() const { return _pNetStats->sendLostRate(); }
+
+	double						recvBatchSize() const { return _pNetStats->recvBatchSize(); }
+	double						sendBatchSize() const { return _pNetStats->sendBatchSize(); }
 	
 	Writer&						writer() { return *_pWriter; }
 
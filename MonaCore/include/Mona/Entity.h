@@ -25,6 +25,10 @@ namespace Mona {
 
 struct Entity : virtual Object {
 	struct Comparator { bool operator()(const UInt8* a, const UInt8* b) const { return memcmp(a, b, SIZE)<0; } };
+	/*!
+	Id is random or a SHA-256, its prefix is already a good hash (see HashMap) */
+	struct Hasher { UInt32 operator()(const UInt8* id) const { UInt32 prefix; memcpy(&prefix, id, sizeof(prefix)); return prefix; } };
+	struct Equal { bool operator()(const UInt8* a, const UInt8* b) const { return memcmp(a, b, SIZE) == 0; } };
 	template<typename EntityType>
 	struct Map : std::map<const UInt8*, EntityType*, Comparator> {
 		using std::map<const UInt8*, EntityType*, Comparator>::map;
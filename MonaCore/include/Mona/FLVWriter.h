@@ -34,6 +34,8 @@ struct FLVWriter : MediaWriter, virtual Object {
 
 	FLVWriter() {}
 
+	bool		shareable() const { return true; }
+
 	void		beginMedia(const OnWrite& onWrite);
 	void		writeProperties(const Media::Properties& properties, const OnWrite& onWrite) { Media::Data::Type type(Media::Data::TYPE_AMF);  write(0, AMF::TYPE_EMPTY, 0, false, 0, 0, properties.data(type), onWrite); }
 	void		writeAudio(UInt8 track, const Media::Audio::Tag& tag, const Packet& packet, const OnWrite& onWrite) { write(track, AMF::TYPE_AUDIO, ToCodecs(tag), tag.isConfig, tag.time, 0, packet, onWrite); }
@@ -32,16 +32,21 @@ struct HTTPFileSender : HTTPSender, File, File::Decoder, virtual Object {
 		const Path& file, Parameters& properties);
 
 	const Path& path() const { return self; }
+	/*!
+	Size to read with IOFile, 0 when content is sent in zero-copy (sendfile) rather than read in user-space buffers */
+	UInt32		readSize() const { return _zeroCopy ? 0 : 0xFFFF; }
 
 private:
 	bool				load(Exception& ex);
 	UInt32				decode(shared<Buffer>& pBuffer, bool end);
+	bool				sendHeader(UInt64 size);
 	const std::string*	search(char c);
 	UInt32				generate(const Packet& packet, std::deque<Packet>& packets);
 
 	Parameters				_properties;
 	MIME::Type				_mime;
 	const char*				_subMime;
+	volatile bool			_zeroCopy;
 
 	// For search!
 	Parameters::const_iterator	_result;
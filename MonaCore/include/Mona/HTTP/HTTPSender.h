@@ -45,7 +45,9 @@ struct HTTPSender : Runner, virtual Object {
 	If extraSize=UINT64_MAX + (path() || !mime): Transfer-Encoding: chunked
 	If extraSize=UINT64_MAX + !path(): live streaming => no content-length, live attributes and close on end of response */
 	bool send(const char* code, MIME::Type mime = MIME::TYPE_UNKNOWN, const char* subMime = NULL, UInt64 extraSize = 0);
-	bool send(const Packet& content);
+	/*!
+	Send content, chunk prefix and content leave in one gathered write */
+	bool send(const Packets& content);
 
 	template <typename ...Args>
 	bool sendError(const char* code, Args&&... args) {
@@ -73,7 +75,7 @@ protected:
 private:
 	virtual const Path& path() const { return Path::Null(); }
 
-	bool socketSend(const Packet& packet);
+	bool socketSend(const Packets& packets);
 	bool run(Exception&) { run(); return true; }
 	virtual void run() {}
 
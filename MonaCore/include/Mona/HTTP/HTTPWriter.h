@@ -66,9 +66,11 @@ struct HTTPWriter : Writer, Media::Target, virtual Object {
 
 	bool			answering() const { return !_flushings.empty() || _session->queueing(); }
 	void			flush() { Writer::flush(); }
+	bool			threadSafe() const { return true; } // one subscription by session, senders queued by writer
 private:
 	void			flush(const shared<HTTPSender>& pSender);
 	void			flushing();
+	void			read(const shared<HTTPFileSender>& pFile) { _session.api.ioFile.read(pFile, pFile->readSize()); }
 	void			closing(Int32 error=0, const char* reason = NULL);
 
 	DataWriter&		writeMessage(bool isResponse);
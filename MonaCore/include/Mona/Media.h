@@ -19,7 +19,7 @@ details (or else see http://www.gnu.org/licenses/).
 #pragma once
 
 #include "Mona/Mona.h"
-#include "Mona/Packet.h"
+#include "Mona/Packets.h"
 #include "Mona/Parameters.h"
 #include "Mona/DataWriter.h"
 #include "Mona/DataReader.h"
@@ -365,12 +365,20 @@ struct Media : virtual Static {
 		virtual bool writeVideo(UInt8 track, const Media::Video::Tag& tag, const Packet& packet, bool reliable);
 		virtual bool writeData(UInt8 track, Media::Data::Type type, const Packet& packet, bool reliable);
 		/*!
+		Media formatted by the subscription ("format" parameter) as a chain of packets, by default every packet is written
+		as a Data::TYPE_MEDIA by writeData, overload it to write the chain in one time (gathered write) */
+		virtual bool writeStream(const Packets& packets, bool reliable);
+		/*!
 		endMedia, tolerates a this deletion (and subscription deletion), should returns flase in this case (else execute a target.flush) */
 		virtual bool endMedia() { return true; }
 	
 		/*!
 		Overload just if target bufferizes data before to send it*/
 		virtual void flush() {}
+		/*!
+		Returns true if target can be written by a fan-out thread (see Publication::setFanOut): it shares no state
+		with an other target or a script, else it is written by the server thread */
+		virtual bool threadSafe() const { return false; }
 
 		bool writeMedia(UInt8 track, const Media::Audio::Tag& tag, const Packet& packet, bool reliable) { return writeAudio(track, tag, packet, reliable); }
 		bool writeMedia(UInt8 track, const Media::Video::Tag& tag, const Packet& packet, bool reliable) { return writeVideo(track, tag, packet, reliable); }
@@ -178,6 +178,7 @@ struct MediaFile : virtual Static  {
 		shared<MediaWriter>		 _pWriter;
 		UInt16					 _writeTrack;
 		bool					 _append;
+		bool					 _direct;
 		UInt8					 _sequences;
 		shared<Playlist::Writer> _pPlaylist;
 	};
@@ -0,0 +1,79 @@
+/*
+This file is a part of MonaSolutions Copyright 2017
+mathieu.poux[a]gmail.com
+jammetthomas[a]gmail.com
+
+This program is free software: you can redistribute it and/or
+modify it under the terms of the the Mozilla Public License v2.0.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+Mozilla Public License v. 2.0 received along this program for more
+details (or else see http://mozilla.org/MPL/2.0/).
+
+*/
+
+#pragma once
+
+#include "Mona/Mona.h"
+#include "Mona/MediaWriter.h"
+#include <mutex>
+
+namespace Mona {
+
+/*!
+Encode-once serialization of a publication, shared by the subscriptions which have the same format and the same timestamp base (see Publication::serializer).
+The first subscription to write a frame serializes it, the following ones writing the same frame get the same packets without new encoding.
+Requires a MediaWriter::shareable() writer, and is used just for audio and video frames (begin/end/properties/data stay by subscription).
+RTMP and RTMFP subscriptions don't use it: FlashWriter writes a tag of 2 or 5 bytes in the message of its own connection
+(chunk stream, stream id, flow), and the payload is already referenced without copy, so there is no encoding to share.
+Thread-safe for the subscriptions written in parallel (see Publication::setFanOut), packets returned are an immutable snapshot
+which stays valid even when an other subscription serializes the next frame */
+struct MediaSerializer : virtual Object {
+	MediaSerializer(const Media::Source& source, unique<MediaWriter>&& pWriter, UInt32 timeBase);
+
+	const Media::Source&	source;
+	const UInt32			timeBase; // subscription time - publication time
+
+	/*!
+	Frames got from cache */
+	UInt64			hits() const { return _hits; }
+	/*!
+	Frames serialized */
+	UInt64			misses() const { return _misses; }
+
+	shared<const Packets>	writeAudio(UInt8 track, const Media::Audio::Tag& tag, const Packet& packet);
+	shared<const Packets>	writeVideo(UInt8 track, const Media::Video::Tag& tag, const Packet& packet);
+
+private:
+	/*!
+	Last frames serialized: audio and video interleaved, and a video frame can be written with and without its CC (see Publication::writeVideo) */
+	enum { FRAMES = 4 };
+	struct Frame : virtual Object {
+		Frame() : type(Media::TYPE_NONE), track(0), time(0), data(NULL), size(0) {}
+		Media::Type			type;
+		UInt8				track;
+		UInt32				time;
+		const UInt8*		data;
+		UInt32				size;
+		Packet				packet; // holds the frame buffer, so data address can't be reused by an other frame
+		shared<Packets>		pPackets; // never changed once returned, a new frame gets a new one
+	};
+	/*!
+	Returns the frame if already serialized, otherwise recycles the oldest frame with empty packets to serialize */
+	Frame& frame(Media::Type type, UInt8 track, UInt32 time, const Packet& packet, bool& serialized);
+
+	std::mutex				_mutex;
+	unique<MediaWriter>		_pWriter;
+	MediaWriter::OnWrite	_onWrite;
+	Packets*				_pSerializing;
+	Frame					_frames[FRAMES];
+	UInt8					_oldest;
+
+	UInt64					_hits;
+	UInt64					_misses;
+};
+
+
+} // namespace Mona
@@ -20,6 +20,7 @@ details (or else see http://www.gnu.org/licenses/).
 
 #include "Mona/Mona.h"
 #include "Mona/Media.h"
+#include "Mona/Packets.h"
 
 namespace Mona {
 
@@ -32,9 +33,15 @@ struct MediaWriter : virtual Object {
 	virtual const char*	format() const;
 	virtual MIME::Type	mime() const;
 	virtual const char* subMime() const;
+	/*!
+	True when the serialization of a frame depends only on the frame and the stream configs (no state between frames),
+	then the result can be shared between all the subscribers of a publication, see MediaSerializer */
+	virtual bool		shareable() const { return false; }
 
-
-	typedef std::function<void(const Packet& packet)> OnWrite;
+	/*!
+	Receives the chain of packets written by the container (header + payload + footer),
+	to send it in one gathered system call without copying the media frame */
+	typedef std::function<void(const Packets& packets)> OnWrite;
 
 	virtual void beginMedia(const OnWrite& onWrite) {}
 	virtual void writeProperties(const Media::Properties& properties, const OnWrite& onWrite) {}
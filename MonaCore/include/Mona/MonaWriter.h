@@ -28,6 +28,8 @@ namespace Mona {
 [UInt32=>size][Media::Pack][...data...] */
 
 struct MonaWriter : MediaWriter, virtual Object {
+	bool shareable() const { return true; }
+
 	void writeAudio(UInt8 track, const Media::Audio::Tag& tag, const Packet& packet, const OnWrite& onWrite) { write(track, tag, packet, onWrite); }
 	void writeVideo(UInt8 track, const Media::Video::Tag& tag, const Packet& packet, const OnWrite& onWrite) { write(track, tag, packet, onWrite); }
 	void writeData(UInt8 track, Media::Data::Type type, const Packet& packet, const OnWrite& onWrite) {
@@ -48,8 +50,7 @@ private:
 		UInt8 buffer[9];
 		BinaryWriter writer(buffer, sizeof(buffer));
 		Media::Pack(writer.write32(Media::PackedSize(tag, track) + packet.size()), tag, track);
-		onWrite(Packet(writer.data(), writer.size()));
-		onWrite(packet);
+		onWrite(Packets(Packet(writer.data(), writer.size())).append(packet));
 	}
 
 	
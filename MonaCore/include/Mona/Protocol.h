@@ -45,6 +45,11 @@ struct Protocol : virtual Object, Parameters {
 protected:
 	Protocol(const char* name, ServerAPI& api, Sessions& sessions);
 	Protocol(const char* name, Protocol& gateway);
+
+	/*!
+	Number of listening sockets to bind on the protocol address ("listeners" parameter, 0 = one by thread), when >1 enables SO_REUSEPORT
+	on socket to let the kernel spread accepts and datagrams between them (Linux), returns 1 if the system can't do it */
+	UInt16 listeners(Socket& socket);
 	
 private:
 	
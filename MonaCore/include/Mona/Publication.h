@@ -24,7 +24,11 @@ details (or else see http://www.gnu.org/licenses/).
 #include "Mona/LostRate.h"
 #include "Mona/MediaFile.h"
 #include "Mona/CCaption.h"
+#include "Mona/MediaSerializer.h"
+#include "Mona/ThreadPool.h"
+#include "Mona/ContiguousSet.h"
 #include <set>
+#include <map>
 
 namespace Mona {
 
@@ -80,7 +84,28 @@ struct Publication : Media::Source, Media::Properties, virtual Object {
 	UInt32							currentTime() const;
 	UInt32							lastTime() const;
 
-	const std::set<Subscription*>	subscriptions;
+	/*!
+	Subscriptions contiguous for the per-frame iteration, an unsubscription during an iteration lets a tombstone removed on flush,
+	or out of an iteration on subscribe/unsubscribe when tombstones exceed the half of the slots */
+	const ContiguousSet<Subscription> subscriptions;
+	/*!
+	Serialization shared by the subscriptions in the same format with the same timestamp base (subscription time - publication time),
+	returns null if format is unknown or its writer is not shareable (see MediaWriter::shareable) */
+	shared<MediaSerializer>			serializer(const char* format, UInt32 timeBase);
+	/*!
+	From threshold subscriptions, audio and video frames are written by shards of subscriptions in parallel on threadPool,
+	each subscription is written by one thread at a time and in order (returns after all shards written). 0 disables it.
+	Just the subscriptions with a thread safe target (see Media::Target::threadSafe) are written in parallel, the others
+	(script target, RTMP and RTMFP writers sharing their session state, media streams) are written after by the server thread */
+	void							setFanOut(const ThreadPool& threadPool, UInt32 threshold) { _pThreadPool = &threadPool; _fanOut = threshold; }
+	/*!
+	GOP cache, keeps in a maxSize bytes budget the audio and video frames since the last key frame of the main video track,
+	to prime a new subscription which can start immediatly without waiting the next key frame (see Subscription "gop" parameter), 0 disables it */
+	void							setGOPCache(UInt32 maxSize) { if (!(_gopMaxSize = maxSize)) clearGOP(); }
+	/*!
+	GOP cache size in bytes */
+	UInt32							gopSize() const { return _gopSize; }
+	const std::deque<unique<Media::Base>>& gop() const { return _gop; }
 
 	void							start(unique<MediaFile::Writer>&& pRecorder = nullptr, bool append = false);
 	void							reset();
@@ -116,6 +141,15 @@ struct Publication : Media::Source, Media::Properties, virtual Object {
 private:
 	void flushProperties();
 
+	template<typename MediaType>
+	void cacheGOP(const typename MediaType::Tag& tag, const Packet& packet, UInt8 track);
+	void clearGOP(bool start = false) { _gop.clear(); _gopSize = 0; _gopping = start; }
+
+	struct FanOut;
+	/*!
+	Write the frame to subscriptions in the fan-out mode if enabled and threshold reached, returns false otherwise */
+	bool fanOut(const Packet& packet, const std::function<void(Subscription&)>& write);
+
 	void startRecording(unique<MediaFile::Writer>&& pRecorder, bool append);
 	void stopRecording();
 
@@ -140,6 +174,17 @@ private:
 	Time							_timeProperties;
 
 	unique<Subscription>			_pRecording;
+
+	std::map<std::string, std::weak_ptr<MediaSerializer>> _serializers;
+	std::mutex						_mutexSerializers; // subscriptions can be written in parallel, see setFanOut
+
+	const ThreadPool*				_pThreadPool;
+	UInt32							_fanOut;
+
+	std::deque<unique<Media::Base>>	_gop;
+	UInt32							_gopSize;
+	UInt32							_gopMaxSize;
+	bool							_gopping; // GOP started, caching until next key frame or budget exceeded
 };
 
 
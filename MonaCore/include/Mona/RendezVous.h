@@ -23,6 +23,7 @@ details (or else see http://www.gnu.org/licenses/).
 #include "Mona/Packet.h"
 #include "Mona/Entity.h"
 #include "Mona/Timer.h"
+#include <set>
 
 namespace Mona {
 
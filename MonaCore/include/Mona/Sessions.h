@@ -22,6 +22,7 @@ details (or else see http://www.gnu.org/licenses/).
 #include "Mona/Socket.h"
 #include "Mona/Logs.h"
 #include "Mona/Entity.h"
+#include "Mona/HashMap.h"
 
 namespace Mona {
 
@@ -32,11 +33,12 @@ enum {
 };
 
 /*!
-Allow to manage sessions + override obsolete session on address duplication */
+Allow to manage sessions + override obsolete session on address duplication
+Sessions by peer id and by address are indexed in open addressing hash tables, lookups done on every incoming packet */
 class Session;
 struct Sessions : virtual Object {
 
-	Sessions() {}
+	Sessions() : _manageId(0), _manageDuration(0), _sweepDuration(0), _sweepMaxDuration(0) {}
 	virtual ~Sessions();
 
 	template<typename SessionType = Session>
@@ -85,7 +87,14 @@ struct Sessions : virtual Object {
 		return *pSession;
 	}
 
-	void	 manage();
+	/*!
+	Manage a slice of sessions to sweep all sessions in 'slices' calls without long pause whatever the sessions count,
+	budget in ms stops the slice before its end when exceeded (0 = no limit), remaining sessions are managed on next call.
+	Returns true when the sweep is complete */
+	bool	 manage(UInt8 slices = 1, UInt32 budget = 0);
+	/*!
+	Duration in ms of the last manage call */
+	UInt32	 manageDuration() const { return _manageDuration; }
 	
 private:
 
@@ -100,8 +109,12 @@ private:
 
 	std::map<UInt32, Session*>			_sessions;
 	std::deque<UInt32>					_freeIds;
-	Entity::Map<Session>				_sessionsByPeerId;
-	std::map<SocketAddress, Session*>	_sessionsByAddress[2]; // 0 - UDP, 1 - TCP
+	UInt32								_manageId; // next session to manage, 0 = new sweep
+	UInt32								_manageDuration;
+	UInt32								_sweepDuration;
+	UInt32								_sweepMaxDuration;
+	HashMap<const UInt8*, Session*, Entity::Hasher, Entity::Equal>	_sessionsByPeerId;
+	HashMap<SocketAddress, Session*, SocketAddress::Hasher>			_sessionsByAddress[2]; // 0 - UDP, 1 - TCP
 };
 
 
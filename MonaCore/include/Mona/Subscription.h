@@ -21,6 +21,8 @@ details (or else see http://www.gnu.org/licenses/).
 #include "Mona/Mona.h"
 #include "Mona/Congestion.h"
 #include "Mona/MediaWriter.h"
+#include "Mona/MediaSerializer.h"
+#include <set>
 
 namespace Mona {
 
@@ -32,6 +34,9 @@ Params:
 	timeout=UInt32 (0 = no timeout)
 	time=Int32 (set current time, if +Int32 or -Int32 it sets a time relative to source, and "time=source" let time of source unchanged)
 	audio|video|data=false|0|UInt8|all|true (disable|disable|track selected|all selected|allselected)
+	gop=true|false (start with the publication GOP cache rather wait the next key frame, true by default)
+	gopBurst=true|false (GOP cache written faster than real time, true by default, false replays it at its timestamps
+	and then the subscription keeps the GOP delay)
 	*/
 struct Publication;
 struct Subscription : Media::Source, Media::Properties, virtual Object {
@@ -153,20 +158,54 @@ private:
 	bool start(UInt8 track, const Media::Video::Tag& tag, const Packet& packet);
 
 	bool next();
+	/*!
+	Prime a new subscription with the publication GOP cache, the frames are written immediatly (faster than real time),
+	or with "gopBurst=false" queued in _paced to be written at their timestamps (see pace) */
+	void prime();
+	/*!
+	Queue the frame behind the GOP replayed at its timestamps, returns false if no replay is in progress */
+	bool delay(const Media::Audio::Tag& tag, const Packet& packet, UInt8 track) { return delay<Media::Audio>(tag, packet, track); }
+	bool delay(const Media::Video::Tag& tag, const Packet& packet, UInt8 track) { return delay<Media::Video>(tag, packet, track); }
+	bool delay(Media::Data::Type type, const Packet& packet, UInt8 track) { return delay<Media::Data>(type, packet, track); }
+	template<typename MediaType>
+	bool delay(const typename MediaType::Tag& tag, const Packet& packet, UInt8 track) {
+		if (_priming || _paced.empty())
+			return false;
+		_paced.emplace_back(std::make_unique<MediaType>(tag, packet, track));
+		pace();
+		return true;
+	}
+	/*!
+	Write the queued frames whose time is reached since the replay start */
+	void pace();
 
 	UInt32 scaleTime(UInt32 time, bool isConfig = true);
+	/*!
+	Returns the publication serializer shared with the other subscriptions in the same format and timeBase, or NULL if format is not shareable */
+	MediaSerializer* serializer(UInt32 timeBase);
 
 	template<typename TracksType, typename TagType>
 	bool writeToTarget(const TracksType& tracks, UInt8 track, const TagType& tag, const Packet& packet, bool isConfig = false) {
 		if (!_target.writeMedia(track, tag, packet, tracks.reliable || isConfig))
 			return false;
+		addFlushable(packet.size());
+		return true;
+	}
+	/*!
+	Write the chain formatted by _pMediaWriter in one time */
+	bool writeToTarget(const Packets& packets) {
+		if (!_target.writeStream(packets, _datas.reliable))
+			return false;
+		addFlushable(packets.size());
+		return true;
+	}
+	void addFlushable(UInt32 size) {
 		if (_flushable >= Net::MTU_RELIABLE_SIZE) {
 			// not call flush() for not update congestion now!
 			_flushable = 0;
 			_target.flush();
 		}
-		_flushable += packet.size();
-		return true;
+		_flushable += size;
 	}
 
 	template<typename TracksType1, typename TracksType2>
@@ -268,6 +307,11 @@ private:
 	bool					_firstTime;
 	UInt32					_startTime;
 
+	bool					_priming;
+	std::deque<unique<Media::Base>> _paced; // GOP replayed at its timestamps followed by the frames received meanwhile
+	Time					_pacedTime; // replay start
+	UInt32					_pacedFrom; // time of the first GOP frame
+
 	unique<UInt32>			_pFromTime;
 	UInt32					_duration;
 
@@ -288,6 +332,7 @@ private:
 	// For "format" parameter
 	MediaWriter::OnWrite	_onMediaWrite;
 	unique<MediaWriter>		_pMediaWriter;
+	shared<MediaSerializer>	_pSerializer;
 };
 
 
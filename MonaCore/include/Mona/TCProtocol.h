@@ -34,7 +34,9 @@ protected:
 	TCProtocol(const char* name, ServerAPI& api, Sessions& sessions, const shared<TLS>& pTLS = nullptr);
 
 private:
-	TCPServer _server;
+	TCPServer							_server;
+	shared<TLS>							_pTLS;
+	std::vector<unique<TCPServer>>		_listeners; // additional listening sockets on the same port (SO_REUSEPORT)
 };
 
 
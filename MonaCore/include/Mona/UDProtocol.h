@@ -33,6 +33,18 @@ struct UDProtocol : Protocol, private UDPSocket, virtual Object {
 	const shared<Socket>& socket() { return UDPSocket::socket(); }
 protected:
 	UDProtocol(const char* name, ServerAPI& api, Sessions& sessions);
+
+private:
+	/*!
+	Additional socket bound on the protocol port (SO_REUSEPORT), with its own decoder and events redirected to the protocol */
+	struct Listener : UDPSocket, virtual Object {
+		Listener(UDProtocol& protocol) : UDPSocket(protocol.io), _protocol(protocol) {}
+	private:
+		Socket::Decoder* newDecoder() { return _protocol.newDecoder(); }
+		UDProtocol& _protocol;
+	};
+
+	std::vector<unique<Listener>> _listeners;
 };
 
 
@@ -36,13 +36,15 @@ struct WSSender : Runner, virtual Object {
 
 protected:
 	virtual bool run(Exception&);
+	/*!
+	Send one message, header and payload written in one time */
+	bool send(const Packets& payload);
+
 	Packet	_packet;
 
 private:
 	const char* name() const { return _name ? _name : (_pSocket->isSecure() ? "WSS" : "WS"); }
 
-	bool send(const Packet& packet);
-
 	unique<DataWriter>	_pWriter;
 	shared<Buffer>		_pBuffer;
 	shared<Socket>		_pSocket;
@@ -58,5 +60,13 @@ private:
 	Media::Data::Type _packetType;
 };
 
+struct WSStreamSender : WSSender, virtual Object {
+	WSStreamSender(const shared<Socket>& pSocket, const Packets& packets, const char* name = NULL) : WSSender(pSocket, WS::TYPE_BINARY, Packet::Null(), name) { _packets.append(packets); }
+private:
+	bool run(Exception&) { send(_packets); return true; }
+
+	Packets _packets;
+};
+
 
 } // namespace Mona
@@ -47,10 +47,12 @@ struct WSWriter : Writer, Media::TrackTarget, virtual Object {
 	bool			writeAudio(const Media::Audio::Tag& tag, const Packet& packet, bool reliable);
 	bool			writeVideo(const Media::Video::Tag& tag, const Packet& packet, bool reliable);
 	bool			writeData(Media::Data::Type type, const Packet& packet, bool reliable);
+	bool			writeStream(const Packets& packets, bool reliable);
 	bool			writeProperties(const Media::Properties& properties);
 	bool			endMedia();
 
 	void			flush() { Writer::flush(); }
+	bool			threadSafe() const { return true; } // one subscription by session, senders queued by writer
 private:
 	
 	void			flushing();
@@ -66,8 +66,7 @@ void ADTSWriter::writeAudio(const Media::Audio::Tag& tag, const Packet& packet,
 	writer.write8((_codecType<<6) | ((_codecType ? _rateIndex : MPEG4::RateToIndex(tag.rate)) << 2) | (((_channels ? _channels : tag.channels) >> 2) & 0x01));
 	writer.write32(((_channels ? _channels : tag.channels) & 0x03)<<30 | (finalSize & 0x1FFF)<<13 | 0x1FFC); // 0x1FFC => buffer fullness all bits to 1 + 1 AAC frame per ADTS frame minus 1 (for compatibility maximum)
 
-	onWrite(Packet(writer.data(), writer.size())); // header
-	onWrite(packet); // content
+	onWrite(Packets(Packet(writer.data(), writer.size())).append(packet)); // header + content
 }
 
 void ADTSWriter::writeVideo(const Media::Video::Tag& tag, const Packet& packet, const OnWrite& onWrite, UInt32& finalSize) {
@@ -132,11 +132,15 @@ void FLVWriter::write(UInt8 track, AMF::Type type, UInt8 codecs, bool isConfig,
 	}
 
 	if (!sps) {
-		onWrite(Packet(pBuffer)); // header
+		// header + payload + footer in one chain to not copy the payload
+		Packets packets;
+		packets.append(Packet(pBuffer)); // header
+		packets.append(packet);
 		pBuffer.set();
-		if (packet)
-			onWrite(packet);
-	} else if (vps)
+		BinaryWriter(*pBuffer).write32(11 + size); // footer
+		return onWrite(packets.append(Packet(pBuffer)));
+	}
+	if (vps)
 		HEVC::WriteVideoConfig(writer, vps, sps, pps); // write vps sps + pps
 	else
 		AVC::WriteVideoConfig(writer, sps, pps); // write sps + pps
@@ -29,6 +29,8 @@ HTTPFileSender::HTTPFileSender(const shared<const HTTP::Header>& pRequest, const
 		File(file, File::MODE_READ), _properties(move(properties)), _mime(MIME::TYPE_UNKNOWN),
 		_pos(0), _step(properties.count()), _stage(0) {
 		_result = _properties.begin(); // do it here to get compatible _properties.begin() and not properties.begin()
+		// zero-copy when file is sent as it is, without TLS encryption or encrypted by the kernel
+		_zeroCopy = !_properties.count() && (!pSocket->isSecure() || pSocket->isKernelSecure());
 }
 
 
@@ -72,7 +74,43 @@ bool HTTPFileSender::load(Exception& ex) {
 	return false;
 }
 
+bool HTTPFileSender::sendHeader(UInt64 size) {
+	_mime = MIME::Read(self, _subMime);
+	if (!_mime) {
+		_mime = MIME::TYPE_APPLICATION;
+		_subMime = "octet-stream";
+	}
+	return send(HTTP_CODE_200, _mime, _subMime, size);
+}
+
 UInt32 HTTPFileSender::decode(shared<Buffer>& pBuffer, bool end) {
+
+	if (_zeroCopy) {
+		// pBuffer is empty (see readSize), file is sent from its reading position by the socket
+		pBuffer.reset(); // no onReaden callback before the end
+		if (!_mime && !sendHeader(size()))
+			return 0;
+		if (pRequest->type != HTTP::TYPE_HEAD) {
+			while (readen() < size()) {
+				Exception ex;
+				int sent = pSocket->sendFile(ex, self, UInt32(min(size() - readen(), UInt64(0x100000))));
+				if (sent > 0)
+					continue;
+				if (!sent)
+					return 0; // congestion, wait onFlush to continue (see HTTPWriter::flushing)
+				if (!ex.cast<Ex::Unsupported>() || readen()) {
+					DEBUG(ex); // no shutdown required, already done by sendFile!
+					return 0;
+				}
+				_zeroCopy = false; // fallback to buffered sending, header is already sent
+				return readSize();
+			}
+		}
+		// END
+		send(Packet::Null());
+		pBuffer.set(); // to get onReaden callback!
+		return 0;
+	}
 	
 	deque<Packet> packets;
 	Packet packet(pBuffer); // capture and hold buffer until end of life of packets
@@ -85,15 +123,8 @@ UInt32 HTTPFileSender::decode(shared<Buffer>& pBuffer, bool end) {
 		size = generate(packet, packets);
 
 	// HEADER
-	if (!_mime) {
-		_mime = MIME::Read(self, _subMime);
-		if (!_mime) {
-			_mime = MIME::TYPE_APPLICATION;
-			_subMime = "octet-stream";
-		}
-		if (!send(HTTP_CODE_200, _mime, _subMime, end ? size : UINT64_MAX))
-			return 0;
-	}
+	if (!_mime && !sendHeader(end ? size : UINT64_MAX))
+		return 0;
 	// CONTENT
 	if (pRequest->type != HTTP::TYPE_HEAD) {
 		for (Packet& packet : packets) {
@@ -38,7 +38,7 @@ HTTPMediaSender::~HTTPMediaSender() {
 }
 
 void HTTPMediaSender::run() {
-	MediaWriter::OnWrite onWrite([this](const Packet& packet) { send(packet); });
+	MediaWriter::OnWrite onWrite([this](const Packets& packets) { send(packets); });
 	if (_first) {
 		// first packet streaming
 		if (send(HTTP_CODE_200, _pWriter->mime(), _pWriter->subMime(), UINT64_MAX))
@@ -40,30 +40,29 @@ void HTTPSender::setCookies(shared<Buffer>& pSetCookie) {
 	_pBuffer->append(EXPAND("\r\n\r\n"));
 }
 
-bool HTTPSender::send(const Packet& content) {
+bool HTTPSender::send(const Packets& content) {
 	if (pRequest->type == HTTP::TYPE_HEAD)
 		return true;
-	if (_chunked) {
-		shared<Buffer> pBuffer(SET);
-		if (_chunked == 2)
-			pBuffer->append(EXPAND("\r\n")); // prefix
-		else
-			++_chunked;
-		String::Append(*pBuffer, String::Format<UInt32>("%X", content.size()), "\r\n");
-		if(!content)
-			pBuffer->append(EXPAND("\r\n")); // end!
-		if (!socketSend(Packet(pBuffer)))
-			return false;
-	}
-	return socketSend(content);
+	if (!_chunked)
+		return socketSend(content);
+	shared<Buffer> pBuffer(SET);
+	if (_chunked == 2)
+		pBuffer->append(EXPAND("\r\n")); // prefix
+	else
+		++_chunked;
+	String::Append(*pBuffer, String::Format<UInt32>("%X", content.size()), "\r\n");
+	if(!content)
+		pBuffer->append(EXPAND("\r\n")); // end!
+	return socketSend(Packets(Packet(pBuffer)).append(content));
 }
 
-bool HTTPSender::socketSend(const Packet& packet) {
-	if (!packet)
+bool HTTPSender::socketSend(const Packets& packets) {
+	if (!packets)
 		return true;
 	Exception ex;
-	DUMP_RESPONSE(pSocket->isSecure() ? "HTTPS" : "HTTP", packet.data(), packet.size(), pSocket->peerAddress());
-	int result = pSocket->write(ex, packet);
+	for (const Packet& packet : packets)
+		DUMP_RESPONSE(pSocket->isSecure() ? "HTTPS" : "HTTP", packet.data(), packet.size(), pSocket->peerAddress());
+	int result = pSocket->write(ex, packets);
 	if (ex || result<0)
 		DEBUG(ex);
 	// no shutdown required, already done by write!
@@ -124,7 +123,7 @@ bool HTTPSender::send(const char* code, MIME::Type mime, const char* subMime, UI
 		String::Append(*pBuffer, "\r\nAccess-Control-Allow-Origin: ", pRequest->origin);
 
 	if (headerEnd)
-		return socketSend(Packet(pBuffer)) && socketSend(pRequest->type == HTTP::TYPE_HEAD ? Packet(_pBuffer, _pBuffer->data(), headerEnd - _pBuffer->data()) : Packet(_pBuffer));
+		return socketSend(Packets(Packet(pBuffer)).append(pRequest->type == HTTP::TYPE_HEAD ? Packet(_pBuffer, _pBuffer->data(), headerEnd - _pBuffer->data()) : Packet(_pBuffer)));
 	// no _pBuffer
 	String::Append(*pBuffer, "\r\n\r\n");
 	return socketSend(Packet(pBuffer));
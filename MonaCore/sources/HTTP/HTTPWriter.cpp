@@ -91,7 +91,7 @@ HTTPWriter::HTTPWriter(TCPSession& session) : _requestCount(0), _requesting(fals
 		_flushings.pop_front();
 		while (!_flushings.empty()) {
 			if (_flushings.front()->isFile())
-				return _session.api.ioFile.read(static_pointer_cast<HTTPFileSender>(_flushings.front())); // wait onFileReaden!
+				return read(static_pointer_cast<HTTPFileSender>(_flushings.front())); // wait onFileReaden!
 			_session.send(_flushings.front());
 			_flushings.pop_front();
 		}
@@ -142,7 +142,7 @@ void HTTPWriter::flush(const shared<HTTPSender>& pSender) {
 		shared<HTTPFileSender> pFileSender = static_pointer_cast<HTTPFileSender>(pSender);
 		_session.api.ioFile.subscribe(pFileSender, (File::Decoder*)pFileSender.get(), _onFileReaden, _onFileError);
 		if (_flushings.empty())
-			_session.api.ioFile.read(pFileSender);
+			read(pFileSender);
 	} else if (_flushings.empty())
 		return _session.send(pSender);
 
@@ -177,7 +177,7 @@ void HTTPWriter::flushing() {
 
 	// continue to read the file if paused on congestion
 	if (flushing && !_session->queueing() && _flushings.front().unique()) // if !_flushings.front().unique() => is reading (+ can cause a double call to _onFileReaden)
-		_session.api.ioFile.read(static_pointer_cast<HTTPFileSender>(_flushings.front()));
+		read(static_pointer_cast<HTTPFileSender>(_flushings.front()));
 }
 
 void HTTPWriter::writeSetCookie(const string& key, DataReader& reader) {
@@ -605,13 +605,15 @@ void MP4Writer::flush(const OnWrite& onWrite, Int8 reset) {
 	// onWrite in last to avoid possible recursivity (for example if onWrite call flush again: _videos or _audios not flushed!)
 	if (!onWrite)
 		return;
+	Packets packets;
 	// header
-	onWrite(Packet(pBuffer)); 
+	packets.append(Packet(pBuffer));
 	// payload
 	for (const deque<Frame>& frames : mediaFrames) {
 		for (const Frame& frame : frames)
-			onWrite(frame);
+			packets.append(frame);
 	}
+	onWrite(packets); // fragment in one chain
 }
 
 void MP4Writer::writeTrack(BinaryWriter& writer, UInt32 track, Frames& frames, UInt32& dataOffset, bool isEnd) {
@@ -445,6 +445,13 @@ bool Media::Target::writeData(UInt8 track, Media::Data::Type type, const Packet&
 	WARN(typeof(self), " doesn't support data streaming");
 	return true;
 }
+bool Media::Target::writeStream(const Packets& packets, bool reliable) {
+	for (const Packet& packet : packets) {
+		if (!writeData(0, Media::Data::TYPE_MEDIA, packet, reliable))
+			return false;
+	}
+	return true;
+}
 bool Media::TrackTarget::writeAudio(const Media::Audio::Tag& tag, const Packet& packet, bool reliable) {
 	WARN(typeof(self), " doesn't support audio streaming");
 	return true;
@@ -170,10 +170,12 @@ unique<MediaFile::Writer> MediaFile::Writer::New(Exception& ex, const char* requ
 }
 
 MediaFile::Writer::File::File(const string& name, const Path& path, const shared<MediaWriter>& pWriter, const shared<Playlist::Writer>& pPlaylist, UInt8 sequences, IOFile& io) : Path(path), name(name), sequence(0), FileWriter(io), pPlaylist(pPlaylist),
-	onWrite([this, address = String(path.parent(), path.name())](const Packet& packet) {
-		DUMP_REQUEST(this->name.c_str(), packet.data(), packet.size(), address);
-		write(packet);
-		// Exception ex; _pFile->write(ex, packet.data(), packet.size()); // Just usefull to test!
+	onWrite([this, address = String(path.parent(), path.name())](const Packets& packets) {
+		for (const Packet& packet : packets) {
+			DUMP_REQUEST(this->name.c_str(), packet.data(), packet.size(), address);
+			write(packet);
+			// Exception ex; _pFile->write(ex, packet.data(), packet.size()); // Just usefull to test!
+		}
 	}) {
 	if (pPlaylist) {
 		setExtension(pWriter->format());// change path to match pWriter
@@ -199,7 +201,7 @@ void MediaFile::Writer::Begin::process(Exception& ex, File& file) {
 }
 
 MediaFile::Writer::Writer(const Path& path, unique<MediaWriter>&& pWriter, IOFile& io) : 
-	path(path), io(io), _writeTrack(0), _pWriter(move(pWriter)), _sequences(1), _append(false),
+	path(path), io(io), _writeTrack(0), _pWriter(move(pWriter)), _sequences(1), _append(false), _direct(false),
 	MediaStream(TYPE_FILE, "Stream target file://...", Path(path.parent()).name(), '/', path.baseName(), '.', path.extension().empty() ? pWriter->format() : path.extension().c_str()) {
 	if (String::ICompare(path.extension(), "m3u8") == 0)
 		_pPlaylist.set<M3U8::Writer>(io);
@@ -214,6 +216,7 @@ bool MediaFile::Writer::starting(const Parameters& parameters) {
 	}
 	// pulse starting, nothing todo (wait beginMedia to create _pFile)
 	parameters.getBoolean("append", _append);
+	parameters.getBoolean("direct", _direct); // write without system cache (O_DIRECT)
 	if (parameters.getNumber<UInt8>("sequences", _sequences)) {
 		if (!_pPlaylist)
 			WARN(description, ", sequences usefull just for segments")
@@ -232,6 +235,7 @@ bool MediaFile::Writer::beginMedia(const string& name) {
 	if (!run())
 		return false;
 	_pFile.set(name, path, _pWriter, _pPlaylist, _sequences, io).onError = [this](const Exception& ex) { stop(LOG_ERROR, ex); };
+	_pFile->direct = _direct;
 	write<Begin>(_append);
 	return true;
 }
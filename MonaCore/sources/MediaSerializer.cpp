@@ -0,0 +1,76 @@
+/*
+This file is a part of MonaSolutions Copyright 2017
+mathieu.poux[a]gmail.com
+jammetthomas[a]gmail.com
+
+This program is free software: you can redistribute it and/or
+modify it under the terms of the the Mozilla Public License v2.0.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+Mozilla Public License v. 2.0 received along this program for more
+details (or else see http://mozilla.org/MPL/2.0/).
+
+*/
+
+#include "Mona/MediaSerializer.h"
+
+using namespace std;
+
+namespace Mona {
+
+MediaSerializer::MediaSerializer(const Media::Source& source, unique<MediaWriter>&& pWriter, UInt32 timeBase) : source(source), timeBase(timeBase),
+	_pWriter(move(pWriter)), _onWrite([this](const Packets& packets) { _pSerializing->append(packets); }),
+	_pSerializing(NULL), _oldest(0), _hits(0), _misses(0) {
+}
+
+shared<const Packets> MediaSerializer::writeAudio(UInt8 track, const Media::Audio::Tag& tag, const Packet& packet) {
+	lock_guard<mutex> lock(_mutex);
+	bool serialized;
+	Frame& frame(this->frame(Media::TYPE_AUDIO, track, tag.time, packet, serialized));
+	if (!serialized)
+		_pWriter->writeAudio(track, tag, packet, _onWrite);
+	return frame.pPackets;
+}
+
+shared<const Packets> MediaSerializer::writeVideo(UInt8 track, const Media::Video::Tag& tag, const Packet& packet) {
+	lock_guard<mutex> lock(_mutex);
+	bool serialized;
+	Frame& frame(this->frame(Media::TYPE_VIDEO, track, tag.time, packet, serialized));
+	if (!serialized)
+		_pWriter->writeVideo(track, tag, packet, _onWrite);
+	return frame.pPackets;
+}
+
+MediaSerializer::Frame& MediaSerializer::frame(Media::Type type, UInt8 track, UInt32 time, const Packet& packet, bool& serialized) {
+	// same frame = same data area of the same publication frame, with the same scaled time
+	for (Frame& frame : _frames) {
+		if (frame.data && packet.data() == frame.data && packet.size() == frame.size && type == frame.type && track == frame.track && time == frame.time) {
+			++_hits;
+			serialized = true;
+			return frame;
+		}
+	}
+	++_misses;
+	serialized = false;
+	Frame& frame(_frames[_oldest]);
+	_oldest = (_oldest + 1) % FRAMES;
+	frame.type = type;
+	frame.track = track;
+	frame.time = time;
+	frame.size = packet.size();
+	if (packet.buffer()) {
+		frame.data = packet.data();
+		frame.packet.set(move(packet)); // just a reference on the buffer
+	} else {
+		// unbuffered frame, its address could be reused by an other frame => no cache
+		frame.data = NULL;
+		frame.packet = nullptr;
+	}
+	_pSerializing = &frame.pPackets.set();
+	return frame;
+}
+
+
+} // namespace Mona
@@ -187,17 +187,26 @@ void MediaSocket::Reader::stopping() {
 
 MediaSocket::Writer::Send::Send(Type type, const shared<string>& pName, const shared<Socket>& pSocket, const shared<MediaWriter>& pWriter) : Runner("MediaSocketSend"),
 	_pSocket(pSocket), pWriter(pWriter), _pName(pName),
-	onWrite([this, type](const Packet& packet) {
-		UInt32 size = 0;
-		Packet chunk(packet);
-		while (chunk += size) {
-			size = (type == TYPE_UDP || type == TYPE_SRT) && chunk.size() > Net::MTU_RELIABLE_SIZE ? Net::MTU_RELIABLE_SIZE : chunk.size();
-			DUMP_RESPONSE(_pName->c_str(), chunk.data(), size, _pSocket->peerAddress());
-			Exception ex;
-			int result = _pSocket->write(ex, Packet(chunk, chunk.data(), size));
-			if (result < 0) // write has failed, no more reliable!
+	onWrite([this, type](const Packets& packets) {
+		Exception ex;
+		if (type != TYPE_UDP && type != TYPE_SRT) {
+			for (const Packet& packet : packets)
+				DUMP_RESPONSE(_pName->c_str(), packet.data(), packet.size(), _pSocket->peerAddress());
+			if (_pSocket->write(ex, packets) < 0) // write has failed, no more reliable!
 				_pSocket->shutdown();
-		};
+			return;
+		}
+		for (const Packet& packet : packets) {
+			UInt32 size = 0;
+			Packet chunk(packet);
+			while (chunk += size) {
+				size = chunk.size() > Net::MTU_RELIABLE_SIZE ? Net::MTU_RELIABLE_SIZE : chunk.size();
+				DUMP_RESPONSE(_pName->c_str(), chunk.data(), size, _pSocket->peerAddress());
+				int result = _pSocket->write(ex, Packet(chunk, chunk.data(), size));
+				if (result < 0) // write has failed, no more reliable!
+					_pSocket->shutdown();
+			};
+		}
 	}) {
 }
 
@@ -88,6 +88,7 @@ void NALNetWriter<VideoType>::writeVideo(const Media::Video::Tag& tag, const Pac
 	}
 	reader.reset();
 
+	Packets packets;
 	while (reader.available()) {
 		UInt32 size(reader.read32());
 		if (size > reader.available())
@@ -99,17 +100,19 @@ void NALNetWriter<VideoType>::writeVideo(const Media::Video::Tag& tag, const Pac
 			Media::Video::Frame frame = VideoType::Frames[type];
 			Nal newNal = (frame == Media::Video::FRAME_INTER || frame == Media::Video::FRAME_KEY) ? NAL_VCL : ((frame == Media::Video::FRAME_CONFIG) ? NAL_CONFIG : NAL_UNDEFINED);
 			if (_nal == NAL_START || (_nal && newNal != _nal))
-				onWrite(_Unit);  // NAL unit delimiter + 00 00 00 01 prefix
+				packets.append(_Unit);  // NAL unit delimiter + 00 00 00 01 prefix
 			else if (newNal == NAL_CONFIG)
-				onWrite(Packet(_Unit, _Unit.data(), 4)); // 00 00 00 01 prefix
+				packets.append(Packet(_Unit, _Unit.data(), 4)); // 00 00 00 01 prefix
 			else
-				onWrite(Packet(_Unit, _Unit.data()+1, 3)); // 00 00 00 01 prefix
-			onWrite(Packet(packet, reader.current(), size));
+				packets.append(Packet(_Unit, _Unit.data()+1, 3)); // 00 00 00 01 prefix
+			packets.append(Packet(packet, reader.current(), size));
 			_nal = newNal;
 		} else
 			_nal = NAL_START;
 		reader.next(size);
 	}
+	if (packets)
+		onWrite(packets); // prefixes + NAL units in one chain
 }
 
 template <class VideoType>
@@ -52,6 +52,20 @@ Socket& Protocol::initSocket(Socket& socket) {
 	DEBUG(name, " set ", socket, " socket buffers set to ", socket.recvBufferSize(), "B in reception and ", socket.sendBufferSize(),"B in sends");
 	return socket;
 }
+UInt16 Protocol::listeners(Socket& socket) {
+	UInt16 count(1);
+	if (!getNumber("listeners", count))
+		getNumber("net.listeners", count);
+	if (!count)
+		count = api.threadPool.threads();
+	if (count < 2)
+		return 1;
+	socket.setReusePort(true);
+	if (socket.getReusePort())
+		return count;
+	WARN(name, " listeners=", count, " ignored, SO_REUSEPORT unsupported");
+	return 1;
+}
 
 
 } // namespace Mona
@@ -27,7 +27,8 @@ namespace Mona {
 
 Publication::Publication(const string& name): _latency(0),
 	audios(_audios), videos(_videos), datas(_datas), _lostRate(_byteRate),
-	_publishing(0),_new(false), _newLost(false), _name(name) {
+	_publishing(0),_new(false), _newLost(false), _name(name), _pThreadPool(NULL), _fanOut(0),
+	_gopSize(0), _gopMaxSize(0), _gopping(false) {
 	DEBUG("New publication ",name);
 }
 
@@ -52,6 +53,103 @@ UInt32 Publication::lastTime() const {
 	return _videos.size() && Util::Distance(_audios.lastTime, _videos.lastTime)>0 ? _videos.lastTime : _audios.lastTime;
 }
 
+shared<MediaSerializer> Publication::serializer(const char* format, UInt32 timeBase) {
+	String key(format, '/', timeBase);
+	lock_guard<mutex> lock(_mutexSerializers);
+	shared<MediaSerializer> pSerializer;
+	auto it = _serializers.find(key);
+	if (it != _serializers.end() && (pSerializer = it->second.lock()))
+		return pSerializer;
+	unique<MediaWriter> pWriter = MediaWriter::New(format);
+	if (!pWriter || !pWriter->shareable())
+		return nullptr;
+	// remove serializers released by their subscriptions
+	for (it = _serializers.begin(); it != _serializers.end();) {
+		if (it->second.expired())
+			it = _serializers.erase(it);
+		else
+			++it;
+	}
+	pSerializer.set(self, move(pWriter), timeBase);
+	_serializers[move(key)] = pSerializer;
+	return pSerializer;
+}
+
+struct Publication::FanOut : virtual Object {
+	FanOut(const ContiguousSet<Subscription>& subscriptions, UInt32 shards, const function<void(Subscription&)>& write) :
+		_subscriptions(subscriptions), _slots(subscriptions.slots()), _shards(min(shards, subscriptions.size())), _write(write), _next(0), _done(0) {}
+
+	UInt32 shards() const { return _shards; }
+
+	/*!
+	Write the shards not yet taken by an other thread */
+	void run() {
+		UInt32 shard;
+		while ((shard = _next++) < _shards) {
+			UInt32 end = UInt32(UInt64(shard + 1) * _slots / _shards);
+			for (UInt32 i = UInt32(UInt64(shard) * _slots / _shards); i < end; ++i) {
+				Subscription* pSubscription = _subscriptions.slot(i);
+				if (pSubscription && pSubscription->target().threadSafe()) // else tombstone, or written after by the server thread
+					_write(*pSubscription);
+			}
+			if (++_done == _shards)
+				_finished.set();
+		}
+	}
+	/*!
+	Write shards with the caller thread too, and wait that all are written */
+	void join() {
+		run();
+		while (_done < _shards)
+			_finished.wait();
+	}
+
+	struct Run : Runner, virtual Object {
+		Run(const shared<FanOut>& pFanOut) : Runner("FanOut"), _pFanOut(pFanOut) {}
+	private:
+		bool run(Exception& ex) { _pFanOut->run(); return true; }
+		shared<FanOut> _pFanOut;
+	};
+
+private:
+	const ContiguousSet<Subscription>&		_subscriptions; // no subscription added or compaction until join returns
+	const UInt32							_slots;
+	const UInt32							_shards;
+	const function<void(Subscription&)>&	_write; // valid until join returns, and just used by the threads which took a shard
+	atomic<UInt32>							_next;
+	atomic<UInt32>							_done;
+	Signal									_finished;
+};
+
+template<typename MediaType>
+void Publication::cacheGOP(const typename MediaType::Tag& tag, const Packet& packet, UInt8 track) {
+	if (!_gopping)
+		return; // wait a key frame
+	if ((_gopSize += packet.size()) > _gopMaxSize) {
+		DEBUG("GOP of ", _name, " exceeds ", _gopMaxSize, " bytes, no GOP cache until the next key frame");
+		return clearGOP();
+	}
+	_gop.emplace_back(make_unique<MediaType>(tag, packet, track)); // just a reference increment on a bufferized packet
+}
+
+bool Publication::fanOut(const Packet& packet, const function<void(Subscription&)>& write) {
+	if (!_fanOut || subscriptions.size() < _fanOut)
+		return false;
+	// bufferize the frame before its distribution (shares then its buffer), a bufferization by subscription would change it concurrently
+	Packet frame(move(packet));
+	ContiguousSet<Subscription>::Iteration iteration(subscriptions); // no compaction while shards are written by slots
+	shared<FanOut> pFanOut(SET, subscriptions, _pThreadPool->threads() + 1, write);
+	for (UInt32 i = 1; i < pFanOut->shards(); ++i)
+		_pThreadPool->queue<FanOut::Run>(nullptr, pFanOut);
+	pFanOut->join();
+	// targets not thread safe (script, state shared between targets) are written by the server thread
+	for (Subscription* pSubscription : subscriptions) {
+		if (!pSubscription->target().threadSafe())
+			write(*pSubscription);
+	}
+	return true;
+}
+
 void Publication::reportLost(Media::Type type, UInt32 lost, UInt8 track) {
 	if (!lost)
 		return;
@@ -89,7 +187,7 @@ void Publication::startRecording(unique<MediaFile::Writer>&& pRecorder, bool app
 	NOTE("Start ", _name, "=>", pRecorder->path.name(), " recording");
 	_pRecording->pPublication = this;
 	_pRecording->setBoolean("append",append);
-	((set<Subscription*>&)subscriptions).emplace(_pRecording.get());
+	((ContiguousSet<Subscription>&)subscriptions).emplace(_pRecording.get());
 	pRecorder->start(); // start MediaFile::Writer before subscription!
 }
 
@@ -97,7 +195,7 @@ void Publication::stopRecording() {
 	if (!_pRecording)
 		return;
 	NOTE("Stop ", _name, "=>", _pRecording->target<MediaFile::Writer>().path.name(), " recording");
-	((set<Subscription*>&)subscriptions).erase(_pRecording.get());
+	((ContiguousSet<Subscription>&)subscriptions).erase(_pRecording.get());
 	_pRecording->pPublication = NULL;
 	delete &_pRecording->target<MediaFile::Writer>();
 	_pRecording.reset();
@@ -126,10 +224,9 @@ void Publication::start(unique<MediaFile::Writer>&& pRecorder, bool append) {
 
 		// Erase track metadata just!
 		clearTracks();
+		clearGOP();
 
-		auto it = subscriptions.begin();
-		while (it != subscriptions.end()) { // using "while" rather "for each" because "reset" can remove an element of "subscriptions"!
-			Subscription* pSubscription(*it++);
+		for (Subscription* pSubscription : subscriptions) { // "reset" can remove an element of "subscriptions" (tombstone skipped)
 			if (pSubscription->pPublication != this && pSubscription->pPublication)
 				continue; // subscriber not yet subscribed
 			pSubscription->pPublication = this;
@@ -188,12 +285,12 @@ void Publication::flush() {
 		_newLost = false;
 	}
 
-	auto it = subscriptions.begin();
-	while (it!=subscriptions.end()) { // using "while" rather "for each" because "flush" can remove an element of "subscriptions"!
-		Subscription* pSubscription(*it++);
+	for (Subscription* pSubscription : subscriptions) { // "flush" can remove an element of "subscriptions" (tombstone skipped)
 		if (pSubscription->pPublication == this || !pSubscription->pPublication)
 			pSubscription->flush();
 	}
+	// remove tombstones of unsubscriptions (without publisher flush, subscribe/unsubscribe compacts beyond half of tombstones)
+	((ContiguousSet<Subscription>&)subscriptions).compact();
 }
 
 
@@ -217,11 +314,19 @@ void Publication::writeAudio(const Media::Audio::Tag& tag, const Packet& packet,
 	_audios.byteRate += packet.size() + sizeof(tag);
 	_new = true;
 	//INFO(name()," audio ",tag.time);
-	for (Subscription* pSubscription : subscriptions) {
-		if (pSubscription->pPublication == this || !pSubscription->pPublication)
-			pSubscription->writeAudio(tag, packet, track);
+	function<void(Subscription&)> write([&](Subscription& subscription) {
+		if (subscription.pPublication == this || !subscription.pPublication)
+			subscription.writeAudio(tag, packet, track);
+	});
+	if (!fanOut(packet, write)) {
+		for (Subscription* pSubscription : subscriptions)
+			write(*pSubscription);
 	}
 
+	// GOP cache after distribution, a new subscription is primed before the frame which starts it
+	if (_gopMaxSize && !tag.isConfig && packet)
+		cacheGOP<Media::Audio>(tag, packet, track);
+
 	// Hold config packet after video distribution to avoid to distribute two times config packet if subscription call beginMedia
 	if (pAudio && tag.isConfig)
 		pAudio->config.set(tag, packet);
@@ -276,14 +381,25 @@ void Publication::writeVideo(const Media::Video::Tag& tag, const Packet& packet,
 	_new = true;
 	//INFO(name(), " video ", tag.time, " (", tag.frame, ")");
 
-	for (Subscription* pSubscription : subscriptions) {
-		if (pSubscription->pPublication != this && pSubscription->pPublication)
-			continue; // subscriber not yet subscribed
-		if (offsetCC && (!pSubscription->datas.pSelection || *pSubscription->datas.pSelection)) { // if a data track is selected => send without CC!
+	function<void(Subscription&)> write([&](Subscription& subscription) {
+		if (subscription.pPublication != this && subscription.pPublication)
+			return; // subscriber not yet subscribed
+		if (offsetCC && (!subscription.datas.pSelection || *subscription.datas.pSelection)) { // if a data track is selected => send without CC!
 			if (packet.size() > offsetCC)
-				pSubscription->writeVideo(tag, packet + offsetCC, track); // without CC
+				subscription.writeVideo(tag, packet + offsetCC, track); // without CC
 		} else
-			pSubscription->writeVideo(tag, packet, track); // with CC
+			subscription.writeVideo(tag, packet, track); // with CC
+	});
+	if (!fanOut(packet, write)) {
+		for (Subscription* pSubscription : subscriptions)
+			write(*pSubscription);
+	}
+
+	// GOP cache after distribution, a new subscription is primed before the frame which starts it
+	if (_gopMaxSize && tag.frame != Media::Video::FRAME_CONFIG && packet) {
+		if (track == 1 && tag.frame == Media::Video::FRAME_KEY)
+			clearGOP(true); // new GOP
+		cacheGOP<Media::Video>(tag, packet, track);
 	}
 
 	// Hold config packet after video distribution to avoid to distribute two times config packet if subscription call beginMedia
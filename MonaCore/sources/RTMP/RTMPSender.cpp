@@ -108,13 +108,8 @@ bool RTMPSender::run(Exception&) {
 	} else
 		DUMP_RESPONSE(_pSocket->isSecure() ? "RTMPS" : "RTMP", _pBuffer->data(), _pBuffer->size(), _pSocket->peerAddress());
 
-	Exception ex;
-	int result = _pSocket->write(ex, Packet(_pBuffer));
-	if (ex || result<0)
-		DEBUG(ex);
-	if (result < 0)
-		return true;
-
+	Packets packets;
+	packets.append(Packet(_pBuffer)); // header
 	if (_packet.size()) {
 		if (_pEncryptKey) {
 			DUMP_RESPONSE("RTMPE", _packet.data(), _packet.size(), _pSocket->peerAddress());
@@ -123,11 +118,12 @@ bool RTMPSender::run(Exception&) {
 			_packet.set(_pBuffer);
 		} else
 			DUMP_RESPONSE(_pSocket->isSecure() ? "RTMPS" : "RTMP", _packet.data(), _packet.size(), _pSocket->peerAddress());
-		if(_pSocket->write(ex, _packet)<0 && !ex)
-			DEBUG(ex);
+		packets.append(_packet); // payload, gathered with header in one write
 	}
-	
-	if (ex)
+
+	Exception ex;
+	int result = _pSocket->write(ex, packets);
+	if (ex || result<0)
 		DEBUG(ex);
 
 	return true;
@@ -58,12 +58,37 @@ Parameters& Server::start(const Parameters& parameters) {
 }
 
 bool Server::run(Exception&, const volatile bool& requestStop) {
-	if (getBoolean<true>("poolBuffers"))
-		Buffer::Allocator::Set<BufferPool>();
+	shared<BufferPool> pBufferPool;
+	if (getBoolean<true>("poolBuffers")) {
+		Buffer::Allocator::Set<BufferPool>(getNumber<UInt64>("buffer.maxMemory"), getNumber<UInt32>("buffer.hugepages"));
+		if ((pBufferPool = Buffer::Allocator::Get<BufferPool>())->arenaSlabs())
+			INFO("BufferPool arena of ", pBufferPool->arenaSlabs(), pBufferPool->arenaHugeTLB() ? " huge pages" : " transparent huge pages");
+	}
+	const char* backend(getString("disk.backend"));
+	if (backend && String::ICompare(backend, "uring") == 0) {
+		if (ioFile.setBackend(IOFile::BACKEND_URING)) {
+			INFO("IOFile uses io_uring");
+		} else
+			WARN("io_uring unsupported by the system, IOFile uses its default backend");
+	}
+	UInt16 shards(getNumber<UInt16>("net.shards"));
+	Exception ex;
+	if (!ioSocket.setShards(ex, shards)) {
+		WARN("IOSocket can't be sharded in ", shards, " reactors, ", ex);
+	} else if (shards > 1)
+		INFO("IOSocket sharded in ", shards, " reactors");
+	backend = getString("net.backend");
+	if (backend && String::ICompare(backend, "uring") == 0) {
+		if (!ioSocket.setBackend(ex, IOSocket::BACKEND_URING)) {
+			WARN("IOSocket uses its default backend, ", ex);
+		} else
+			INFO("IOSocket uses io_uring");
+	}
 
 	{ // encapsulate Sessions
 		Sessions sessions;
 		Timer::OnTimer onManage;
+		Timer::OnTimer onManageSessions;
 #if !defined(_DEBUG)
 		try
 #endif
@@ -80,8 +105,15 @@ bool Server::run(Exception&, const volatile bool& requestStop) {
 				WARN("No TLS/SSL server protocols, no ", key.name(), " file")
 			else
 				AUTO_ERROR(TLS::Create(ex = nullptr, cert, key, pTLSServer), "SSL Server");
+			if (getBoolean<false>("TLS.kernel")) {
+				if (pTLSServer)
+					AUTO_WARN(pTLSServer->setKernel(ex = nullptr, true), "SSL Server");
+				if (pTLSClient)
+					AUTO_WARN(pTLSClient->setKernel(ex = nullptr, true), "SSL Client");
+			}
 
 			UInt32 countClient(0);
+			UInt32 arenaOccupancy(0);
 			
 			_protocols.start(self, sessions);
 
@@ -90,8 +122,15 @@ bool Server::run(Exception&, const volatile bool& requestStop) {
 			// Start streams after onStart to get onPublish/onSubscribe permissions!
 			loadIniStreams();
 
+			// manage sessions by slices every 100ms to sweep all sessions every 2 seconds without long pause
+			UInt32 manageBudget(getNumber<UInt32, 20>("net.manageBudget"));
+			onManageSessions = ([&](UInt32) {
+				sessions.manage(20, manageBudget);
+				return 100;
+			});
+			_timer.set(onManageSessions, 100);
+
 			onManage = ([&](UInt32) {
-				sessions.manage(); // in first to detect session useless died
 				_protocols.manage(); // manage custom protocol manage (resource protocols)
 
 				// Reset subscriptions of streams target
@@ -117,6 +156,11 @@ bool Server::run(Exception&, const volatile bool& requestStop) {
 				this->onManage(); // client manage (script, etc..)
 				if (clients.size() != countClient)
 					INFO((countClient = clients.size()), " clients");
+				if (pBufferPool) {
+					pBufferPool->manage(); // release unused buffers even without allocation activity
+					if (pBufferPool->arenaOccupancy() != arenaOccupancy)
+						INFO("BufferPool arena ", (arenaOccupancy = pBufferPool->arenaOccupancy()), "/", pBufferPool->arenaSlabs(), " huge pages used");
+				}
 				// TODO? relayer.manage();
 				return 2000;
 			}); // manage every 2 seconds!
@@ -137,6 +181,7 @@ bool Server::run(Exception&, const volatile bool& requestStop) {
 	#endif
 		// Stop onManage (useless now)
 		_timer.set(onManage, 0);
+		_timer.set(onManageSessions, 0);
 
 		// do a handler flush here too because few MediaStream like MediaLogger can have tasks to do after 
 		_handler.flush();
@@ -60,6 +60,8 @@ Publication* ServerAPI::publish(Exception& ex, const string& stream, const char*
 		ERROR(ex.set<Ex::Intern>(stream, " is already publishing"));
 		return NULL;
 	}
+	publication.setFanOut(threadPool, getNumber<UInt32>("fanOut"));
+	publication.setGOPCache(getNumber<UInt32>("gopCache"));
 
 	if (query) {
 		// write metadata!
@@ -232,7 +234,7 @@ bool ServerAPI::subscribe(Exception& ex, Publication& publication, Subscription&
 			WARN(ex.set<Ex::Permission>("Not authorized to play ", publication.name()));
 		return false;
 	}
-	((set<Subscription*>&)publication.subscriptions).emplace(&subscription);
+	((ContiguousSet<Subscription>&)publication.subscriptions).emplace(&subscription);
 
 	if (subscription.pPublication)
 		unsubscribe(subscription, subscription.setNext(&publication), pClient); // publication switch (MBR) + cancel possible previous next!
@@ -253,7 +255,7 @@ void ServerAPI::unsubscribe(Subscription& subscription, Client* pClient) {
 void ServerAPI::unsubscribe(Subscription& subscription, Publication* pPublication, Client* pClient) {
 	if (!pPublication)
 		return;
-	if (!((set<Subscription*>&)pPublication->subscriptions).erase(&subscription))
+	if (!((ContiguousSet<Subscription>&)pPublication->subscriptions).erase(&subscription))
 		return; // no subscription
 	DEBUG((pClient ? pClient->address : typeof(self)), " unsubscribes to ", pPublication->name());
 	if (pClient && !pClient->connection)
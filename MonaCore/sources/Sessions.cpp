@@ -50,13 +50,15 @@ void Sessions::addByAddress(Session& session) {
 		const auto& it = map.emplace(session.peer.address, &session);
 		if (it.second)
 			return;
-		INFO(it.first->second->name(), " overloaded by ", session.name(), " (by ", session.peer.address, ")");
-		const auto& itSession = _sessions.find(it.first->second->_id);
+		Session& overloaded(*it.first->second);
+		INFO(overloaded.name(), " overloaded by ", session.name(), " (by ", session.peer.address, ")");
+		const auto& itSession = _sessions.find(overloaded._id);
 		if (itSession == _sessions.end())
-			CRITIC("Overloaded ", it.first->second->name(), " impossible to find in sessions collection")
+			CRITIC("Overloaded ", overloaded.name(), " impossible to find in sessions collection")
 		else
 			remove(itSession, SESSION_BYPEER);
-		it.first->second = &session;
+		// search again the entry, killing the overloaded session can have changed the map
+		map.emplace(session.peer.address, &session).first->second = &session;
 	}
 }
 
@@ -88,16 +90,20 @@ void Sessions::removeByAddress(const SocketAddress& address, Session& session) {
 
 void Sessions::addByPeer(Session& session) {
 	if (session._sessionsOptions&SESSION_BYPEER) {
-		const auto& it = _sessionsByPeerId.emplace(session);
+		const auto& it = _sessionsByPeerId.emplace(session, &session);
 		if (it.second)
 			return;
-		INFO(it.first->second->name(), " overloaded by ", session.name(), " (by peer id)");
-		const auto& itSession = _sessions.find(it.first->second->_id);
+		Session& overloaded(*it.first->second);
+		INFO(overloaded.name(), " overloaded by ", session.name(), " (by peer id)");
+		const auto& itSession = _sessions.find(overloaded._id);
 		if (itSession == _sessions.end())
-			CRITIC("Overloaded ", it.first->second->name(), " impossible to find in sessions collection")
+			CRITIC("Overloaded ", overloaded.name(), " impossible to find in sessions collection")
 		else
 			remove(itSession, SESSION_BYADDRESS);
-		it.first->second = &session;
+		// search again the entry, killing the overloaded session can have changed the map
+		const auto& itPeer = _sessionsByPeerId.emplace(session, &session).first;
+		itPeer->first = session; // key points the id of the session removed
+		itPeer->second = &session;
 	}
 }
 
@@ -135,9 +141,15 @@ void Sessions::remove(const map<UInt32, Session*>::iterator& it, SESSION_OPTIONS
 }
 
 
-void Sessions::manage() {
-	auto it = _sessions.begin();
-	while (it != _sessions.end()) {
+bool Sessions::manage(UInt8 slices, UInt32 budget) {
+	Time::Elapsed elapsed;
+	if (!_manageId) // new sweep
+		_sweepDuration = _sweepMaxDuration = 0;
+	// slice from the current count, sessions created during the sweep don't delay its end
+	UInt32 slice(slices > 1 ? UInt32((_sessions.size() + slices - 1) / slices) : UInt32(_sessions.size()));
+	UInt32 count(0);
+	auto it = _sessions.lower_bound(_manageId);
+	while (it != _sessions.end() && count++ < slice && (!budget || elapsed() < budget)) {
 		Session& session(*it->second);
 		if (!session.died && session.manage())
 			session.flush();
@@ -148,6 +160,18 @@ void Sessions::manage() {
 		}
 		++it;
 	}
+	_manageDuration = UInt32(elapsed());
+	_sweepDuration += _manageDuration;
+	if (_manageDuration > _sweepMaxDuration)
+		_sweepMaxDuration = _manageDuration;
+	if (it != _sessions.end()) {
+		_manageId = it->first;
+		return false;
+	}
+	_manageId = 0;
+	if (_sweepDuration)
+		DEBUG("Sessions manage of ", _sessions.size(), " sessions in ", _sweepDuration, "ms (longest slice ", _sweepMaxDuration, "ms)");
+	return true;
 }
 
 
@@ -36,12 +36,12 @@ bool Subscription::MediaTrack::setLastTime(UInt32 time) {
 
 Subscription::Subscription(Media::Target& target) : pPublication(NULL), _pNextPublication(NULL), _target(target), _ejected(EJECTED_NONE),
 	_flushable(0), audios(_audios), videos(_videos), datas(_datas), _streaming(0), _firstTime(true), _timeout(0), _startTime(0), _seekTime(0),
-	_audios(true), _videos(true), _datas(true), _timeoutMBRUP(10000), _medias(self), _updating(0), _duration(0) {
+	_audios(true), _videos(true), _datas(true), _timeoutMBRUP(10000), _medias(self), _updating(0), _duration(0), _priming(false), _pacedFrom(0) {
 }
 
 Subscription::Subscription(Media::TrackTarget& target) : pPublication(NULL), _pNextPublication(NULL), _target(target), _ejected(EJECTED_NONE),
 	_flushable(0), audios(_audios), videos(_videos), datas(_datas), _streaming(0), _firstTime(true), _timeout(0), _startTime(0), _seekTime(0),
-	_audios(false), _videos(false), _datas(false), _timeoutMBRUP(10000), _medias(self), _updating(0), _duration(0) {
+	_audios(false), _videos(false), _datas(false), _timeoutMBRUP(10000), _medias(self), _updating(0), _duration(0), _priming(false), _pacedFrom(0) {
 }
 
 Subscription::~Subscription() {
@@ -199,8 +199,8 @@ bool Subscription::start() {
 	}
 
 	if (_pMediaWriter && !_onMediaWrite) {
-		_onMediaWrite = [this](const Packet& packet) {
-			if(!writeToTarget(_datas, 0, Media::Data::TYPE_MEDIA, packet))
+		_onMediaWrite = [this](const Packets& packets) {
+			if (!writeToTarget(packets))
 				_ejected = EJECTED_ERROR;
 		};
 		_pMediaWriter->beginMedia(_onMediaWrite);
@@ -262,6 +262,8 @@ bool Subscription::start(UInt32 time) {
 	return insideDuration(time) && start();
 }
 bool Subscription::start(UInt8 track, Media::Data::Type type, const Packet& packet) {
+	if (delay(type, packet, track))
+		return false; // written after the GOP replay
 	// In first flush medias previous media before to progress timeline (setLastTime)
 	if (_pNextPublication && _medias.add(type, packet, track))
 		return false;
@@ -269,6 +271,8 @@ bool Subscription::start(UInt8 track, Media::Data::Type type, const Packet& pack
 }
 bool Subscription::start(UInt8 track, const Media::Audio::Tag& tag, const Packet& packet) {
 	if (tag.isConfig) {
+		if (delay(tag, packet, track))
+			return false; // written after the GOP replay
 		if (!_streaming && pPublication)
 			return false; // ignored, will be sent on start
 		return start(); // config packet has to be ignored by time progression and from/duration processing
@@ -276,10 +280,15 @@ bool Subscription::start(UInt8 track, const Media::Audio::Tag& tag, const Packet
 	// In first flush medias previous media before to progress timeline (setLastTime)
 	if (_pNextPublication && _medias.add(tag, packet, track))
 		return false;
+	prime();
+	if (delay(tag, packet, track))
+		return false; // written after the GOP replay
 	return _audios.setLastTime(track, tag.time) && start(tag.time);
 }
 bool Subscription::start(UInt8 track, const Media::Video::Tag& tag, const Packet& packet) {
 	if (tag.frame == Media::Video::FRAME_CONFIG) {
+		if (delay(tag, packet, track))
+			return false; // written after the GOP replay
 		if (!_streaming && pPublication)
 			return false; // ignored, will be sent on start
 		return start(); // config packet has to be ignored by time progression and from/duration processing
@@ -287,13 +296,60 @@ bool Subscription::start(UInt8 track, const Media::Video::Tag& tag, const Packet
 	// In first flush medias previous media before to progress timeline (setLastTime)
 	if (_pNextPublication && _medias.add(tag, packet, track))
 		return false;
+	if (track != 1 || tag.frame != Media::Video::FRAME_KEY)
+		prime(); // else this key frame starts a new GOP, useless to replay the previous one
+	if (delay(tag, packet, track))
+		return false; // written after the GOP replay
 	return _videos.setLastTime(track, tag.time) && start(tag.time);
 }
 
+void Subscription::prime() {
+	// "gop" parameter, true by default: start with the GOP cache rather wait the next key frame
+	if (_streaming || _priming || !_paced.empty() || !pPublication || pPublication->gop().empty() || typeid(_target) == typeid(Medias) || !getBoolean<true>("gop"))
+		return;
+	if (!getBoolean<true>("gopBurst")) {
+		// replay at the GOP timestamps, frames are copied (packet references) because the GOP cache changes on next key frame
+		for (const unique<Media::Base>& pMedia : pPublication->gop()) {
+			if (pMedia->type == Media::TYPE_AUDIO)
+				_paced.emplace_back(std::make_unique<Media::Audio>(((const Media::Audio&)*pMedia).tag, *pMedia, pMedia->track));
+			else
+				_paced.emplace_back(std::make_unique<Media::Video>(((const Media::Video&)*pMedia).tag, *pMedia, pMedia->track));
+		}
+		_pacedFrom = _paced.front()->time();
+		_pacedTime.update();
+		return; // the caller queues its frame behind and starts the replay (see delay)
+	}
+	_priming = true; // frames primed pass here too!
+	for (const unique<Media::Base>& pMedia : pPublication->gop()) {
+		writeMedia(*pMedia);
+		if (_ejected || !_streaming)
+			break; // failed or can't start (from/duration parameters for example), retry on next frame
+	}
+	_priming = false;
+}
+
+void Subscription::pace() {
+	_priming = true; // frames paced pass here too!
+	while (!_paced.empty()) {
+		const Media::Base& media(*_paced.front());
+		if (media.hasTime() && Int32(media.time() - _pacedFrom) > Int32(_pacedTime.elapsed()))
+			break; // not yet
+		unique<Media::Base> pMedia(move(_paced.front()));
+		_paced.pop_front();
+		writeMedia(*pMedia);
+		if (_ejected) {
+			_paced.clear();
+			break;
+		}
+	}
+	_priming = false;
+}
+
 void Subscription::reset() {
 	if(_ejected) // else is a publication reset (smooth publication transition, key frame should come in first)
 		_waitingFirstVideoSync.update(); // to retablish audio/video sync!
 	_ejected = EJECTED_NONE; // Reset => maybe the next publication will solve ejection
+	_paced.clear(); // GOP replay canceled
 	if (!_streaming)
 		return;
 	if (next())
@@ -473,8 +529,13 @@ void Subscription::writeAudio(const Media::Audio::Tag& tag, const Packet& packet
 	if (Logs::GetLevel() >= LOG_TRACE && pPublication && typeid(_target)!=typeid(Medias))
 		TRACE(pPublication->name(), " audio time, ", tag.time, "=>", audio.time, tag.isConfig ? " (7)" : " (1)");
 
-	if (_pMediaWriter)
-		_pMediaWriter->writeAudio(track, audio, packet, _onMediaWrite);
+	if (_pMediaWriter) {
+		MediaSerializer* pSerializer = serializer(audio.time - tag.time);
+		if (pSerializer)
+			_onMediaWrite(*pSerializer->writeAudio(track, audio, packet));
+		else
+			_pMediaWriter->writeAudio(track, audio, packet, _onMediaWrite);
+	}
 	else if(!writeToTarget(_audios, track, audio, packet, tag.isConfig))
 		_ejected = EJECTED_ERROR;
 }
@@ -541,8 +602,13 @@ void Subscription::writeVideo(const Media::Video::Tag& tag, const Packet& packet
 	if (Logs::GetLevel() >= LOG_TRACE && pPublication && typeid(_target) != typeid(Medias))
 		TRACE(pPublication->name(), " video time, ", tag.time, "=>", video.time, " (", video.frame, ")");
 
-	if (_pMediaWriter)
-		_pMediaWriter->writeVideo(track, video, packet, _onMediaWrite);
+	if (_pMediaWriter) {
+		MediaSerializer* pSerializer = serializer(video.time - tag.time);
+		if (pSerializer)
+			_onMediaWrite(*pSerializer->writeVideo(track, video, packet));
+		else
+			_pMediaWriter->writeVideo(track, video, packet, _onMediaWrite);
+	}
 	else if (!writeToTarget(_videos, track, video, packet, isConfig))
 		_ejected = EJECTED_ERROR;
 }
@@ -575,16 +641,27 @@ UInt32 Subscription::scaleTime(UInt32 time, bool isConfig) {
 	return time - _startTime + _seekTime;
 }
 
+MediaSerializer* Subscription::serializer(UInt32 timeBase) {
+	if (!pPublication || !_onMediaWrite || !_pMediaWriter->shareable() || typeid(_target) == typeid(Medias))
+		return NULL;
+	if (!_pSerializer || &_pSerializer->source != pPublication || _pSerializer->timeBase != timeBase)
+		_pSerializer = pPublication->serializer(_pMediaWriter->format(), timeBase);
+	return _pSerializer.get();
+}
+
 void Subscription::setFormat(const char* format) {
 	if (!format && !_pMediaWriter)
 		return;
 	reset(); // end in first to finish the previous format streaming => new format = new stream
 	_pMediaWriter = format ? MediaWriter::New(format) : nullptr;
+	_pSerializer.reset();
 	if (format && !_pMediaWriter)
 		WARN(typeof(_target), " subscription format ", format, " unknown or unsupported");
 }
 
 void Subscription::flush() {
+	if (!_paced.empty())
+		pace(); // even without new frame
 	_flushable = 0;
 	_target.flush(); // keep flush free even if ejected (usefull for example for ServerAPI::WaitingSync)
 	if (_streaming) { // no "ejected" check because it's valid to switch when ejected (can potentialy solve the ejection)
@@ -634,7 +711,7 @@ void Subscription::Medias::setNext(Publication* pNextPublication) {
 		_nextSize = 0;
 
 		// unsubscribe in last to have "_nextSize = 0" and like that no reset packet stacked!
-		((set<Subscription*>&)_pNextSubscription->pPublication->subscriptions).erase(_pNextSubscription.get());
+		((ContiguousSet<Subscription>&)_pNextSubscription->pPublication->subscriptions).erase(_pNextSubscription.get());
 		// reinitialize subscription instead of recreate it (more faster on multiple MBR switch)
 		_pNextSubscription->release();
 	}
@@ -666,7 +743,7 @@ void Subscription::Medias::setNext(Publication* pNextPublication) {
 		_pNextSubscription->_datas.pSelection.set(*_subscription.datas.pSelection);
 	else
 		_pNextSubscription->_datas.pSelection.reset();
-	((set<Subscription*>&)pNextPublication->subscriptions).emplace(_pNextSubscription.get());
+	((ContiguousSet<Subscription>&)pNextPublication->subscriptions).emplace(_pNextSubscription.get());
 	_nextTimeout.update();
 }
 
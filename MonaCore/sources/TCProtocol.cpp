@@ -23,7 +23,7 @@ using namespace std;
 
 namespace Mona {
 
-TCProtocol::TCProtocol(const char* name, ServerAPI& api, Sessions& sessions, const shared<TLS>& pTLS) : _server(api.ioSocket, pTLS), Protocol(name, api, sessions),
+TCProtocol::TCProtocol(const char* name, ServerAPI& api, Sessions& sessions, const shared<TLS>& pTLS) : _server(api.ioSocket, pTLS), _pTLS(pTLS), Protocol(name, api, sessions),
 	onConnection(_server.onConnection) {
 	_server.onError = [this](const Exception& ex) {
 		if (onError)
@@ -33,10 +33,26 @@ TCProtocol::TCProtocol(const char* name, ServerAPI& api, Sessions& sessions, con
 }
 
 SocketAddress TCProtocol::load(Exception& ex) {
-	initSocket(*_server);
+	UInt16 count = listeners(initSocket(*_server));
 	if (!hasKey("timeout"))
 		ex.set<Ex::Intern>("no TCP connection timeout");
-	return _server.start(ex, address) ? _server->address() : SocketAddress::Wildcard();
+	if (!_server.start(ex, address))
+		return SocketAddress::Wildcard();
+	// additional listeners on the same port, kernel spreads the connections between them
+	while (--count) {
+		_listeners.emplace_back();
+		TCPServer& server = _listeners.back().set(api.ioSocket, _pTLS);
+		server.onConnection = _server.onConnection;
+		server.onError = _server.onError;
+		initSocket(*server).setReusePort(true);
+		Exception exListener;
+		if (!server.start(exListener, _server->address())) {
+			WARN("Protocol ", name, " listener, ", exListener);
+			_listeners.pop_back();
+			break;
+		}
+	}
+	return _server->address();
 }
 
 
@@ -251,8 +251,9 @@ void TSWriter::writeAudio(UInt8 track, const Media::Audio::Tag& tag, const Packe
 	if (it->second) {
 		// AAC
 		UInt32 finalSize;
-		MediaTrackWriter::OnWrite onAudioWrite([this, &itPID, &tag, &writer, &finalSize](const Packet& packet) {
-			writeES(writer, itPID->first, itPID->second, tag.time, 0, packet, finalSize);
+		MediaTrackWriter::OnWrite onAudioWrite([this, &itPID, &tag, &writer, &finalSize](const Packets& packets) {
+			for (const Packet& packet : packets)
+				writeES(writer, itPID->first, itPID->second, tag.time, 0, packet, finalSize);
 		});
 		it->second->writeAudio(tag, packet, onAudioWrite, finalSize);
 	} else // MP3
@@ -292,8 +293,9 @@ void TSWriter::writeVideo(UInt8 track, const Media::Video::Tag& tag, const Packe
 	shared<Buffer> pBuffer(SET);
 	BinaryWriter writer(*pBuffer);
 	UInt32 finalSize;
-	MediaTrackWriter::OnWrite onVideoWrite([this, &itPID, &tag, &writer, &finalSize](const Packet& packet){
-		writeES(writer, itPID->first, itPID->second, tag.time, tag.compositionOffset, packet, finalSize, tag.frame==Media::Video::FRAME_KEY);
+	MediaTrackWriter::OnWrite onVideoWrite([this, &itPID, &tag, &writer, &finalSize](const Packets& packets){
+		for (const Packet& packet : packets)
+			writeES(writer, itPID->first, itPID->second, tag.time, tag.compositionOffset, packet, finalSize, tag.frame==Media::Video::FRAME_KEY);
 	});
 	it->second->writeVideo(tag, packet, onVideoWrite, finalSize);
 	onWrite(Packet(pBuffer));
@@ -33,8 +33,24 @@ UDProtocol::UDProtocol(const char* name, ServerAPI& api, Sessions& sessions) : U
 }
 
 SocketAddress UDProtocol::load(Exception& ex) {
-	initSocket(*self);
-	return bind(ex, address) ? self->address() : SocketAddress::Wildcard();
+	UInt16 count = listeners(initSocket(*self));
+	if (!bind(ex, address))
+		return SocketAddress::Wildcard();
+	// additional listeners on the same port, kernel hashes datagrams on their address to keep a peer on the same socket
+	while (--count) {
+		_listeners.emplace_back();
+		Listener& listener = _listeners.back().set(self);
+		listener.onPacket = UDPSocket::onPacket;
+		listener.onError = UDPSocket::onError;
+		initSocket(*listener).setReusePort(true);
+		Exception exListener;
+		if (!listener.bind(exListener, self->address())) {
+			WARN("Protocol ", name, " listener, ", exListener);
+			_listeners.pop_back();
+			break;
+		}
+	}
+	return self->address();
 }
 
 
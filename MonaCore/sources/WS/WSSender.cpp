@@ -54,10 +54,15 @@ bool WSSender::run(Exception&) {
 		}
 	}
 
+	send(_packet);
+	return true;
+}
+
+bool WSSender::send(const Packets& payload) {
 	if(!_pBuffer)
 		_pBuffer.set(10);
 
-	UInt32 size(_pBuffer->size() - 10 + _packet.size());
+	UInt32 size(_pBuffer->size() - 10 + payload.size());
 	UInt8 headerSize(size < 126 ? 2 : (size < 65536 ? 4 : 10));
 
 	_pBuffer->clip(10 - headerSize); // += offset
@@ -72,19 +77,13 @@ bool WSSender::run(Exception&) {
 	else
 		writer.write8(127).write64(size);
 
-	if (!send(Packet(_pBuffer)))
-		return true;
-
-	if (_packet)
-		send(_packet);
-
-	return true;
-}
-
-bool WSSender::send(const Packet& packet) {
+	Packet header(_pBuffer);
+	Packets packets(header);
+	packets.append(payload);
 	Exception ex;
-	DUMP_RESPONSE(name(), packet.data(), packet.size(), _pSocket->peerAddress());
-	int result = _pSocket->write(ex, packet);
+	for (const Packet& packet : packets)
+		DUMP_RESPONSE(name(), packet.data(), packet.size(), _pSocket->peerAddress());
+	int result = _pSocket->write(ex, packets);
 	if (ex || result<0)
 		DEBUG(ex);
 	return result >= 0;
@@ -90,6 +90,12 @@ bool WSWriter::writeData(Media::Data::Type type, const Packet& packet, bool reli
 	return !closed();
 }
 
+bool WSWriter::writeStream(const Packets& packets, bool reliable) {
+	// binary => "format" option choosen by the client, one message by chain written in one time
+	newSender<WSStreamSender>(packets);
+	return !closed();
+}
+
 bool WSWriter::writeProperties(const Media::Properties& properties) {
 	// Necessary TEXT(JSON) transfer (to match data publication)
 	Media::Data::Type type(Media::Data::TYPE_JSON);
@@ -95,12 +95,14 @@ static int endMedia(lua_State *pState) {
 
 template<> void Script::ObjInit(lua_State *pState, MediaWriter& writer) {
 	SCRIPT_BEGIN(pState)
-		lua_pushlightuserdata(pState, new MediaWriter::OnWrite([pState, &writer](const Packet& packet) {
+		lua_pushlightuserdata(pState, new MediaWriter::OnWrite([pState, &writer](const Packets& packets) {
 			SCRIPT_BEGIN(pState)
-				SCRIPT_MEMBER_FUNCTION_BEGIN(writer, "onWrite")
-					SCRIPT_WRITE_PACKET(packet)
-					SCRIPT_FUNCTION_CALL
-				SCRIPT_FUNCTION_END
+				for (const Packet& packet : packets) { // script receives one packet by call
+					SCRIPT_MEMBER_FUNCTION_BEGIN(writer, "onWrite")
+						SCRIPT_WRITE_PACKET(packet)
+						SCRIPT_FUNCTION_CALL
+					SCRIPT_FUNCTION_END
+				}
 			SCRIPT_END
 		}));
 		lua_rawseti(pState, -3, 0);
@@ -53,6 +53,16 @@ static int sendLostRate(lua_State *pState) {
 		SCRIPT_WRITE_DOUBLE(stats.sendLostRate());
 	SCRIPT_CALLBACK_RETURN;
 }
+static int recvBatchSize(lua_State *pState) {
+	SCRIPT_CALLBACK(Net::Stats, stats);
+		SCRIPT_WRITE_DOUBLE(stats.recvBatchSize());
+	SCRIPT_CALLBACK_RETURN;
+}
+static int sendBatchSize(lua_State *pState) {
+	SCRIPT_CALLBACK(Net::Stats, stats);
+		SCRIPT_WRITE_DOUBLE(stats.sendBatchSize());
+	SCRIPT_CALLBACK_RETURN;
+}
 static int queueing(lua_State *pState) {
 	SCRIPT_CALLBACK(Net::Stats, stats);
 		SCRIPT_WRITE_DOUBLE(stats.queueing());
@@ -67,6 +77,8 @@ template<> void Script::ObjInit(lua_State *pState, Net::Stats& stats) {
 		SCRIPT_DEFINE_FUNCTION("sendTime", sendTime);
 		SCRIPT_DEFINE_FUNCTION("sendByteRate", sendByteRate);
 		SCRIPT_DEFINE_FUNCTION("sendLostRate", sendLostRate);
+		SCRIPT_DEFINE_FUNCTION("recvBatchSize", recvBatchSize);
+		SCRIPT_DEFINE_FUNCTION("sendBatchSize", sendBatchSize);
 		SCRIPT_DEFINE_FUNCTION("queueing", queueing);
 	SCRIPT_END;
 }
@@ -79,6 +79,12 @@ static int latency(lua_State *pState) {
 	SCRIPT_CALLBACK_RETURN
 }
 
+static int gopSize(lua_State *pState) {
+	SCRIPT_CALLBACK(Publication, publication)
+		SCRIPT_WRITE_INT(publication.gopSize())
+	SCRIPT_CALLBACK_RETURN
+}
+
 template<> void Script::ObjInit(lua_State *pState, Publication& publication) {
 	AddType<Media::Source>(pState, publication);
 
@@ -92,6 +98,7 @@ template<> void Script::ObjInit(lua_State *pState, Publication& publication) {
 		SCRIPT_DEFINE("videos", AddObject(pState, publication.videos));
 		SCRIPT_DEFINE("datas", AddObject(pState, publication.datas));
 		SCRIPT_DEFINE_FUNCTION("latency", &latency);
+		SCRIPT_DEFINE_FUNCTION("gopSize", &gopSize);
 		SCRIPT_DEFINE_FUNCTION("byteRate", &byteRate<const Publication>);
 		SCRIPT_DEFINE_FUNCTION("lostRate", &lostRate<const Publication>);
 	SCRIPT_END;
@@ -0,0 +1,108 @@
+/*
+This file is a part of MonaSolutions Copyright 2017
+mathieu.poux[a]gmail.com
+jammetthomas[a]gmail.com
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License received along this program for more
+details (or else see http://www.gnu.org/licenses/).
+
+*/
+
+#include "Mona/TraceLogger.h"
+#include "Mona/Logs.h"
+#include "Mona/Util.h"
+
+using namespace std;
+using namespace Mona;
+
+/*!
+MonaTrace renders .trace files of TraceLogger (see logs.trace configuration)
+- in the text format of FileLogger on the standard output
+- or in a pcap file with dump payloads (link type USER0) */
+
+static bool Load(const char* path, Buffer& buffer) {
+	Exception ex;
+	File file(path, File::MODE_READ);
+	if (file.load(ex)) {
+		buffer.resize(range<UInt32>(file.size()), false);
+		if (file.read(ex, buffer.data(), buffer.size()) == int(buffer.size()))
+			return true;
+	}
+	fprintf(stderr, "%s\n", ex ? ex.c_str() : String("Impossible to read ", path).c_str());
+	return false;
+}
+
+static void WriteText(const TraceLogger::Record& record, Buffer& out) {
+	if (record.type == TraceLogger::TYPE_LOG) {
+		String::Append(out, String::Log(Logs::LevelToString(record.level), string(record.file), record.line, record.text, record.threadId, record.time));
+		return;
+	}
+	Date(record.time).format("%d/%m %H:%M:%S.%c  ", out);
+	String::Append(out, record.text, '\n');
+	static Buffer Hex;
+	Util::Dump(record.data, record.size, Hex);
+	out.append(Hex.data(), Hex.size());
+}
+
+static const UInt32 SnapLen(262144); // max of tcpdump/wireshark, a bigger payload is truncated
+
+static void WritePcap(const TraceLogger::Record& record, Buffer& out) {
+	if (record.type != TraceLogger::TYPE_DUMP)
+		return;
+	BinaryWriter writer(out, Byte::ORDER_LITTLE_ENDIAN);
+	if (!writer.size()) // global header
+		writer.write32(0xa1b2c3d4).write16(2).write16(4).write32(0).write32(0).write32(SnapLen).write32(147); // LINKTYPE_USER0
+	writer.write32(UInt32(record.time / 1000)).write32(UInt32(record.time % 1000) * 1000);
+	UInt32 size(min(record.size, SnapLen));
+	writer.write32(size).write32(record.size).write(record.data, size);
+}
+
+int main(int argc, const char* argv[]) {
+	const char* pcap(NULL);
+	vector<const char*> paths;
+	for (int i = 1; i < argc; ++i) {
+		if (String::ICompare(argv[i], "--pcap=", 7) == 0)
+			pcap = argv[i] + 7;
+		else
+			paths.emplace_back(argv[i]);
+	}
+	if (paths.empty()) {
+		fprintf(stderr, "Usage: MonaTrace [--pcap=<output.pcap>] <file.trace> [<file.trace> ...]\n");
+		return 1;
+	}
+	Buffer out;
+	for (const char* path : paths) {
+		Buffer buffer;
+		if (!Load(path, buffer))
+			return 1;
+		TraceLogger::Reader reader(buffer.data(), buffer.size());
+		TraceLogger::Record record;
+		while (reader.read(record)) {
+			if (pcap) {
+				WritePcap(record, out);
+				continue;
+			}
+			WriteText(record, out);
+			fwrite(out.data(), 1, out.size(), stdout);
+			out.clear();
+		}
+		if (reader.corrupted())
+			fprintf(stderr, "%s is corrupted\n", path);
+	}
+	if (!pcap)
+		return 0;
+	Exception ex;
+	File file(pcap, File::MODE_WRITE);
+	if (file.write(ex, out.data(), out.size()))
+		return 0;
+	fprintf(stderr, "%s\n", ex.c_str());
+	return 1;
+}
@@ -78,4 +78,43 @@ ADD_TEST(BufferPool) {
 	CHECK(buffer1.capacity() == 1024);
 }
 
+ADD_TEST(BufferPoolStats) {
+	Buffer::Allocator::Set<BufferPool>(0x10000); // 64KB at maximum
+	shared<BufferPool> pPool(Buffer::Allocator::Get<BufferPool>());
+	CHECK(pPool && pPool->maxMemory() == 0x10000);
+	// stats of thread magazines are published in the depot by batch and on thread exit
+	thread([]() {
+		for (UInt8 i = 0; i < 2; ++i) {
+			vector<unique<Buffer>> buffers(1000);
+			for (unique<Buffer>& pBuffer : buffers)
+				pBuffer.set(1000);
+		}
+	}).join();
+	CHECK(pPool->hits(1024) && (pPool->hits(1024) + pPool->misses(1024)) == 2000);
+	CHECK(pPool->memory(1024) == pPool->memory() && pPool->memory() == 0x10000);
+	Buffer::Allocator::Set(); // reset default Allocator
+	CHECK(!Buffer::Allocator::Get<BufferPool>());
+}
+
+ADD_TEST(BufferPoolArena) {
+	Buffer::Allocator::Set<BufferPool>(0, 4); // arena of 4 huge pages
+	shared<BufferPool> pPool(Buffer::Allocator::Get<BufferPool>());
+	CHECK(pPool && pPool->arenaSlabs() == 4 && !pPool->arenaOccupancy());
+	{
+		vector<unique<Buffer>> buffers(40);
+		for (unique<Buffer>& pBuffer : buffers)
+			pBuffer.set(100000); // 128KB => 16 by slab
+		CHECK(pPool->arenaSlabs(0x20000) == 3 && pPool->arenaBuffers(0x20000) == 40 && pPool->arenaOccupancy() == 3);
+		// last slab for a 2MB buffer, then arena is full => system allocation
+		Buffer buffer1(0x200000), buffer2(0x200000);
+		CHECK(pPool->arenaSlabs(0x200000) == 1 && pPool->arenaBuffers(0x200000) == 1 && pPool->arenaOccupancy() == 4);
+	}
+	unique<Buffer> pBuffer;
+	pBuffer.set(100000);
+	UInt32 buffers(pPool->arenaBuffers(0x20000));
+	Buffer::Allocator::Set(); // reset default Allocator
+	pBuffer.reset(); // buffer of the arena freed by the default allocator => returns to the arena
+	CHECK(pPool->arenaBuffers(0x20000) == buffers - 1);
+}
+
 }
@@ -0,0 +1,112 @@
+/*
+This file is a part of MonaSolutions Copyright 2017
+mathieu.poux[a]gmail.com
+jammetthomas[a]gmail.com
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License received along this program for more
+details (or else see http://www.gnu.org/licenses/).
+
+*/
+
+#include "Mona/UnitTest.h"
+#include "Mona/ContiguousSet.h"
+#include "Mona/Util.h"
+#include <set>
+#include <deque>
+
+using namespace Mona;
+using namespace std;
+
+namespace ContiguousSetTest {
+
+struct Subscriber : virtual Object {
+	Subscriber() : frames(0) {}
+	UInt32 frames;
+	UInt8  state[256]; // size order of a real subscription
+};
+
+ADD_TEST(EraseWhileIterating) {
+	deque<Subscriber> subscribers(5);
+	ContiguousSet<Subscriber> set;
+	for (Subscriber& subscriber : subscribers)
+		CHECK(set.emplace(&subscriber));
+	CHECK(!set.emplace(&subscribers[2]) && set.size() == 5 && set.count(&subscribers[2]));
+
+	UInt32 iterated(0);
+	for (Subscriber* pSubscriber : set) {
+		if (pSubscriber == &subscribers[1]) {
+			CHECK(set.erase(&subscribers[1]) && set.erase(&subscribers[3]) && !set.erase(&subscribers[3]));
+			CHECK(set.emplace(&subscribers[3])); // added again at the end
+		}
+		++pSubscriber->frames;
+		++iterated;
+	}
+	CHECK(iterated == 5 && set.size() == 4 && set.slots() == 6 && !set.count(&subscribers[1]));
+	CHECK(subscribers[1].frames == 1 && subscribers[3].frames == 1);
+
+	set.compact();
+	CHECK(set.size() == 4 && set.slots() == 4);
+	iterated = 0;
+	for (Subscriber* pSubscriber : set) {
+		CHECK(pSubscriber != &subscribers[1]);
+		++iterated;
+	}
+	CHECK(iterated == 4 && set.erase(&subscribers[3]) && set.count(&subscribers[4]));
+	set.compact();
+	CHECK(set.size() == 3 && set.begin() != set.end());
+	for (Subscriber& subscriber : subscribers)
+		set.erase(&subscriber);
+	CHECK(set.empty() && set.begin() == set.end());
+}
+
+ADD_TEST(CompactOnChurn) {
+	deque<Subscriber> subscribers(8);
+	ContiguousSet<Subscriber> set;
+	for (Subscriber& subscriber : subscribers)
+		set.emplace(&subscriber);
+	{
+		ContiguousSet<Subscriber>::Iteration iteration(set);
+		for (UInt32 i = 0; i < 6; ++i)
+			set.erase(&subscribers[i]);
+		CHECK(set.size() == 2 && set.slots() == 8); // no compaction during an iteration
+	}
+	CHECK(set.emplace(&subscribers[0]) && set.size() == 3 && set.slots() == 3); // compacted before to add, without compact() call
+	CHECK(set.erase(&subscribers[6]) && set.erase(&subscribers[7]) && set.slots() == 1 && *set.begin() == &subscribers[0]);
+}
+
+// Per-frame fan-out cost: one iteration over all the subscribers by frame, 1M subscriber writes by test
+static const UInt32 Writes(1000000);
+
+template<typename SetType>
+static void FanOut(UInt32 count) {
+	deque<unique<Subscriber>> subscribers;
+	deque<shared<Buffer>> allocations; // other allocations between subscriptions as in a running server
+	SetType set;
+	for (UInt32 i = 0; i < count; ++i) {
+		subscribers.emplace_back(new Subscriber());
+		allocations.emplace_back(SET, Util::Random<UInt16>() & 0xFFF);
+		set.emplace(subscribers.back().get());
+	}
+	for (UInt32 frame = 0; frame < Writes / count; ++frame) {
+		for (Subscriber* pSubscriber : set)
+			++pSubscriber->frames;
+	}
+	CHECK(subscribers.back()->frames == Writes / count);
+}
+
+ADD_TEST(TreeFanOut10) { FanOut<std::set<Subscriber*>>(10); }
+ADD_TEST(ContiguousFanOut10) { FanOut<ContiguousSet<Subscriber>>(10); }
+ADD_TEST(TreeFanOut1K) { FanOut<std::set<Subscriber*>>(1000); }
+ADD_TEST(ContiguousFanOut1K) { FanOut<ContiguousSet<Subscriber>>(1000); }
+ADD_TEST(TreeFanOut10K) { FanOut<std::set<Subscriber*>>(10000); }
+ADD_TEST(ContiguousFanOut10K) { FanOut<ContiguousSet<Subscriber>>(10000); }
+
+}
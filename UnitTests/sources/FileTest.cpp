@@ -101,9 +101,12 @@ ADD_TEST(FileReader) {
 	CHECK(handler.join(3));
 }
 
-ADD_TEST(FileWriter) {
+void TestFileWriter(IOFile::Backend backend = IOFile::BACKEND_SYSTEM) {
 	MainHandler handler;
 	IOFile		io(handler, _ThreadPool);
+	if (!io.setBackend(backend))
+		return; // unsupported by the system
+	CHECK(io.backend() == backend);
 	const char* name("temp.mona");
 	Exception ex;
 	Packet salut(EXPAND("Salut"));
@@ -124,17 +127,99 @@ ADD_TEST(FileWriter) {
 	writer.write(salut);
 	io.join();
 	CHECK(writer->written() == 10 && writer->size(true) == 10);
+	// burst of writings gathered
+	for (UInt16 i = 0; i < 1000; ++i)
+		writer.write(salut);
+	io.join();
+	CHECK(writer->written() == 5010 && writer->size(true) == 5010 && !writer.queueing());
 	writer.close();
 	
 	onFlush = false;
 	writer.open(name, true).write(salut);
 	io.join();
 	CHECK(onFlush); // onFlush!
-	CHECK(writer->written()==5 && writer->size(true) == 15);
+	CHECK(writer->written()==5 && writer->size(true) == 5015);
 	writer.close();
 
 	CHECK(handler.join(2)); // 2 writing step = 2 onFlush!
 	CHECK(FileSystem::Delete(ex, name) && !ex);
 }
 
+ADD_TEST(FileWriter) {
+	TestFileWriter();
+}
+
+ADD_TEST(FileWriterURing) {
+	TestFileWriter(IOFile::BACKEND_URING);
+}
+
+ADD_TEST(FileWriterURingFiles) {
+	// writings of several files submitted together
+	MainHandler handler;
+	IOFile		io(handler, _ThreadPool);
+	if (!io.setBackend(IOFile::BACKEND_URING))
+		return; // unsupported by the system
+	Exception ex;
+	Packet salut(EXPAND("Salut"));
+	vector<unique<FileWriter>> writers;
+	for (UInt8 i = 0; i < 8; ++i) {
+		writers.emplace_back(new FileWriter(io));
+		writers.back()->onError = [](const Exception& ex) {
+			FATAL_ERROR("FileWriter, ", ex);
+		};
+		writers.back()->open(String("temp", i, ".mona")).write(salut);
+	}
+	io.join();
+	for (UInt16 i = 0; i < 100; ++i) {
+		for (unique<FileWriter>& pWriter : writers)
+			pWriter->write(salut);
+	}
+	io.join();
+	for (UInt8 i = 0; i < 8; ++i) {
+		CHECK((*writers[i])->written() == 505 && (*writers[i])->size(true) == 505 && !writers[i]->queueing());
+		writers[i]->close();
+		CHECK(FileSystem::Delete(ex, String("temp", i, ".mona")) && !ex);
+	}
+}
+
+ADD_TEST(FileWriterDirect) {
+	MainHandler handler;
+	IOFile		io(handler, _ThreadPool);
+	const char* name("temp.mona");
+	Exception ex;
+	shared<Buffer> pBuffer(SET, 5000);
+	for (UInt32 i = 0; i < pBuffer->size(); ++i)
+		pBuffer->data()[i] = UInt8(i);
+	Packet packet(pBuffer);
+
+	FileWriter writer(io);
+	writer.onError = [](const Exception& ex) {
+		FATAL_ERROR("FileWriter, ", ex);
+	};
+	writer.direct = true;
+	writer.open(name);
+	for (UInt8 i = 0; i < 100; ++i)
+		writer.write(packet);
+	io.join();
+	CHECK(writer->written() == 500000);
+	writer.write(packet);
+	io.join();
+	CHECK(writer->written() == 505000);
+	writer.close(); // write the last block by the IOFile queue
+	io.join(); // file released after its last block
+	// append to an unaligned size disables direct mode
+	writer.open(name, true).write(packet);
+	io.join();
+	CHECK(!writer->direct() && writer->size(true) == 510000);
+	writer.close();
+
+	File file(name, File::MODE_READ);
+	CHECK(file.size() == 510000);
+	char data[5000];
+	while (file.read(ex, data, sizeof(data)) > 0)
+		CHECK(memcmp(data, packet.data(), sizeof(data)) == 0);
+	CHECK(!ex && file.readen() == 510000);
+	CHECK(FileSystem::Delete(ex, name) && !ex);
+}
+
 }
@@ -0,0 +1,111 @@
+/*
+This file is a part of MonaSolutions Copyright 2017
+mathieu.poux[a]gmail.com
+jammetthomas[a]gmail.com
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License received along this program for more
+details (or else see http://www.gnu.org/licenses/).
+
+*/
+
+#include "Mona/UnitTest.h"
+#include "Mona/HashMap.h"
+#include "Mona/SocketAddress.h"
+#include "Mona/Util.h"
+#include <map>
+
+using namespace Mona;
+using namespace std;
+
+namespace HashMapTest {
+
+struct Collider { UInt32 operator()(UInt32 key) const { return key & 3; } }; // clusters to stress backward shift erasing
+
+ADD_TEST(EmplaceFindErase) {
+	HashMap<UInt32, UInt32, Collider> map;
+	CHECK(map.empty() && map.capacity() == 16 && map.find(1) == map.end());
+	for (UInt32 i = 0; i < 1000; ++i)
+		CHECK(map.emplace(i, i * 2).second);
+	CHECK(map.size() == 1000 && map.capacity() == 2048);
+	const auto& it = map.emplace(10, 0);
+	CHECK(!it.second && it.first->second == 20);
+
+	vector<UInt32> keys;
+	for (UInt32 i = 0; i < 1000; i += 2)
+		keys.emplace_back(i);
+	for (UInt32 i = 0; i < keys.size(); ++i) // shuffle
+		swap(keys[i], keys[Util::Random<UInt32>() % keys.size()]);
+	for (UInt32 key : keys)
+		CHECK(map.erase(key) == 1 && map.erase(key) == 0);
+	CHECK(map.size() == 500);
+	for (UInt32 i = 0; i < 1000; ++i) {
+		const auto& it = map.find(i);
+		CHECK((i & 1) ? (it != map.end() && it->second == i * 2) : (it == map.end() && !map.count(i)));
+	}
+	UInt32 count(0);
+	for (const auto& it : map)
+		CHECK((it.first & 1) && ++count);
+	CHECK(count == 500);
+	map.erase(map.find(1));
+	CHECK(map.size() == 499 && !map.count(1));
+	map.clear();
+	CHECK(map.empty() && map.begin() == map.end());
+}
+
+// Sessions lookups on incoming packets, by address (UDP) and by peer id (RTMFP)
+static const UInt32 Sessions(100000);
+static const UInt32 Lookups(200000);
+
+template<typename MapType, typename KeyType>
+void Lookup(const vector<KeyType>& keys) {
+	MapType map;
+	for (const KeyType& key : keys)
+		CHECK(map.emplace(key, nullptr).second);
+	for (UInt32 i = 0; i < Lookups; ++i)
+		CHECK(map.find(keys[(i * 7919) % keys.size()]) != map.end());
+}
+
+static const vector<SocketAddress>& Addresses() {
+	static vector<SocketAddress> Addresses;
+	if (Addresses.empty()) {
+		Addresses.reserve(Sessions);
+		in_addr host;
+		for (UInt32 i = 0; i < Sessions; ++i) {
+			host.s_addr = UInt32(0x0A000000 + (i >> 4)); // 16 clients behind each IP
+			Addresses.emplace_back(IPAddress(host), UInt16(1024 + (i & 0xF)));
+		}
+	}
+	return Addresses;
+}
+
+struct Id { UInt8 id[32]; };
+struct IdComparator { bool operator()(const UInt8* a, const UInt8* b) const { return memcmp(a, b, 32) < 0; } };
+struct IdHasher { UInt32 operator()(const UInt8* id) const { UInt32 prefix; memcpy(&prefix, id, sizeof(prefix)); return prefix; } };
+struct IdEqual { bool operator()(const UInt8* a, const UInt8* b) const { return memcmp(a, b, 32) == 0; } };
+
+static const vector<const UInt8*>& Ids() {
+	static deque<Id> Ids(Sessions);
+	static vector<const UInt8*> Pointers;
+	if (Pointers.empty()) {
+		for (Id& id : Ids) {
+			Util::Random(id.id, sizeof(id.id));
+			Pointers.emplace_back(id.id);
+		}
+	}
+	return Pointers;
+}
+
+ADD_TEST(TreeByAddress100K) { Lookup<map<SocketAddress, void*>>(Addresses()); }
+ADD_TEST(HashByAddress100K) { Lookup<HashMap<SocketAddress, void*, SocketAddress::Hasher>>(Addresses()); }
+ADD_TEST(TreeByPeer100K) { Lookup<map<const UInt8*, void*, IdComparator>>(Ids()); }
+ADD_TEST(HashByPeer100K) { Lookup<HashMap<const UInt8*, void*, IdHasher, IdEqual>>(Ids()); }
+
+}
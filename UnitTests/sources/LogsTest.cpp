@@ -0,0 +1,167 @@
+/*
+This file is a part of MonaSolutions Copyright 2017
+mathieu.poux[a]gmail.com
+jammetthomas[a]gmail.com
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License received along this program for more
+details (or else see http://www.gnu.org/licenses/).
+
+*/
+
+#include "Mona/UnitTest.h"
+#include "Mona/Logs.h"
+#include "Mona/TraceLogger.h"
+#include <thread>
+
+using namespace Mona;
+using namespace std;
+
+namespace LogsTest {
+
+static const UInt32 Threads(4);
+static const UInt32 Messages(5000);
+
+struct TestLogger : Logger {
+	TestLogger(map<UInt32, vector<UInt32>>& messages) : _messages(messages) {}
+	bool log(LOG_LEVEL level, const Path& file, long line, const string& message) {
+		if (level != LOG_NOTE) // ignore dropped logs warning
+			return true;
+		UInt32 value;
+		if (String::ToNumber(message, value))
+			_messages[Logs::ThreadId()].emplace_back(value);
+		return true;
+	}
+	bool dump(const string& header, const UInt8* data, UInt32 size) { return true; }
+private:
+	map<UInt32, vector<UInt32>>& _messages;
+};
+
+void Produce(UInt32 capacity, bool toggle = false) {
+	map<UInt32, vector<UInt32>> messages; // by thread id
+	Logs::RemoveLogger("console");
+	Logs::AddLogger<TestLogger>("test", messages);
+	LOG_LEVEL level(Logs::GetLevel());
+	Logs::SetLevel(LOG_NOTE);
+	UInt64 dropped(Logs::Dropped());
+
+	Logs::SetAsync(capacity);
+	vector<thread> threads;
+	vector<UInt32> ids(Threads);
+	atomic<UInt32> running(Threads);
+	for (UInt32 i = 0; i < Threads; ++i) {
+		threads.emplace_back([&ids, &running, i]() {
+			ids[i] = Thread::CurrentId();
+			for (UInt32 j = 0; j < Messages; ++j)
+				NOTE(j);
+			--running;
+		});
+	}
+	while (toggle && running) { // stop and restart asynchronous logs while threads log
+		Logs::SetAsync(0);
+		Logs::SetAsync(capacity);
+	}
+	for (thread& thread : threads)
+		thread.join();
+	Logs::SetAsync(0); // last drain
+	CHECK(!Logs::GetAsync());
+
+	Logs::SetLevel(level);
+	Logs::RemoveLogger("test");
+	Logs::AddLogger<ConsoleLogger>("console");
+
+	// each thread logs are received in order with the emitter thread id, and a log is either received or dropped
+	UInt32 received(0);
+	for (UInt32 id : ids) {
+		const vector<UInt32>& values(messages[id]);
+		for (UInt32 i = 1; i < values.size(); ++i)
+			CHECK(values[i] > values[i - 1]);
+		received += values.size();
+	}
+	CHECK(messages.size() == Threads);
+	CHECK(received + (Logs::Dropped() - dropped) == Threads * Messages);
+	if (capacity >= Messages)
+		CHECK(received == Threads * Messages);
+}
+
+ADD_TEST(Async) {
+	Produce(Messages);
+}
+
+ADD_TEST(AsyncDropped) {
+	Produce(4);
+}
+
+ADD_TEST(AsyncStop) {
+	Produce(Messages, true);
+}
+
+struct DumpLogger : Logger {
+	DumpLogger(string& header, Buffer& payload) : _header(header), _payload(payload) {}
+	bool binary() const { return true; }
+	bool log(LOG_LEVEL level, const Path& file, long line, const string& message) { return true; }
+	bool dump(const string& header, const UInt8* data, UInt32 size) {
+		_header = header;
+		_payload.append(data, size);
+		return true;
+	}
+private:
+	string& _header;
+	Buffer& _payload;
+};
+
+ADD_TEST(AsyncDump) {
+	string header;
+	Buffer payload;
+	Logs::AddLogger<DumpLogger>("dump", header, payload);
+	Logs::SetDump("");
+	Logs::SetAsync(16);
+	thread([]() { DUMP("TEST", BIN "\x01\x02\x03", 3, "header"); }).join();
+	Logs::SetAsync(0); // last drain
+	Logs::SetDump(NULL);
+	Logs::RemoveLogger("dump");
+	CHECK(header == "header" && payload.size() == 3 && memcmp(payload.data(), EXPAND("\x01\x02\x03")) == 0);
+}
+
+ADD_TEST(Trace) {
+	Exception ex;
+	const char* dir("temp.trace/");
+	FileSystem::Delete(ex, dir, FileSystem::MODE_HEAVY); // remains of a failed test
+	CHECK(FileSystem::CreateDirectory(ex = nullptr, dir) && !ex);
+	Path file(__FILE__);
+	{
+		TraceLogger logger(dir);
+		CHECK(logger.binary());
+		CHECK(logger.log(LOG_WARN, file, 10, "message") && logger.dump("header", BIN "\x01\x02\x03", 3) && logger.log(LOG_INFO, file, 11, ""));
+	}
+	File trace(String(dir, "0.trace"), File::MODE_READ);
+	CHECK(trace.load(ex) && !ex);
+	Buffer buffer(range<UInt32>(trace.size()));
+	CHECK(trace.read(ex, buffer.data(), buffer.size()) == int(buffer.size()) && !ex);
+
+	TraceLogger::Reader reader(buffer.data(), buffer.size());
+	TraceLogger::Record record;
+	CHECK(reader.read(record) && record.type == TraceLogger::TYPE_LOG && record.level == LOG_WARN && file == record.file && record.line == 10 && record.text == "message");
+	CHECK(record.threadId == Thread::CurrentId() && record.time <= Time::Now() && record.time > (Time::Now() - 10000));
+	CHECK(reader.read(record) && record.type == TraceLogger::TYPE_DUMP && record.text == "header" && record.size == 3 && memcmp(record.data, EXPAND("\x01\x02\x03")) == 0);
+	CHECK(reader.read(record) && record.type == TraceLogger::TYPE_LOG && record.level == LOG_INFO && file == record.file && record.line == 11 && record.text.empty());
+	CHECK(!reader.read(record) && !reader.corrupted());
+
+	// truncated log
+	TraceLogger::Reader truncatedLog(buffer.data(), buffer.size() - 1);
+	CHECK(truncatedLog.read(record) && truncatedLog.read(record) && !truncatedLog.read(record) && truncatedLog.corrupted());
+	// truncated dump
+	TraceLogger::Reader truncatedDump(buffer.data(), buffer.size() - 22);
+	CHECK(truncatedDump.read(record) && !truncatedDump.read(record) && truncatedDump.corrupted());
+
+	CHECK(FileSystem::Delete(ex, dir, FileSystem::MODE_HEAVY) && !ex);
+}
+
+}
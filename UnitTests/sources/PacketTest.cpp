@@ -17,9 +17,10 @@ details (or else see http://www.gnu.org/licenses/).
 */
 
 #include "Mona/UnitTest.h"
-#include "Mona/Packet.h"
+#include "Mona/Packets.h"
 #include "Mona/String.h"
 #include <deque>
+#include <thread>
 
 using namespace Mona;
 using namespace std;
@@ -94,17 +95,82 @@ ADD_TEST(Bufferize) {
 	CHECK(!packet.buffer());
 	const UInt8* data(packet.data());
 	packets.emplace_back(move(packet));
-	CHECK(packet.buffer() && &packet.buffer() != &packets.back().buffer() && data != packet.data());
+	CHECK(packet.buffer() && &packet.buffer() == &packets.back().buffer() && data != packet.data()); // same holder shared
 
 	// test buffered data
 	shared<Buffer> pBuffer(SET, packet.data(), packet.size());
 	CHECK(packet.set(pBuffer).buffer());
 	data = packet.data();
 	packets.emplace_back(move(packet));
-	CHECK(packet.buffer() && &packet.buffer() != &packets.back().buffer() && data == packet.data());
+	CHECK(packet.buffer() && &packet.buffer() == &packets.back().buffer() && data == packet.data());
 
 	packet = nullptr;
 	CHECK(!packet.buffer());
 }
 
+ADD_TEST(Chain) {
+	Packets packets;
+	CHECK(!packets && !packets.count() && packets.begin() == packets.end());
+	// inline packets, then spilled to the heap, data still valid after the release of the sources
+	for (UInt8 i = 0; i < 20; ++i) {
+		Packet packet(EXPAND("data"));
+		packets.append(packet);
+		packets.append(Packet());
+		CHECK(packets.count() == i + 1u && packets.size() == (i + 1u) * 4 && packets.back().buffer() && memcmp(packets.back().data(), "data", 4) == 0);
+	}
+	UInt32 size(0);
+	for (const Packet& packet : packets)
+		CHECK(memcmp(packet.data(), "data", 4) == 0 && (size += packet.size()));
+	CHECK(size == packets.size());
+	CHECK(!packets.reset() && !packets.count() && packets.append(Packet(EXPAND("ata"))).count() == 1);
+	PacketATA(packets.front(), true);
+}
+
+ADD_TEST(ConcurrentCapture) {
+	// parallel fan-out: threads capture the same buffer and share the same bufferized packet at the same time
+	shared<const Buffer> pBuffer(shared<Buffer>(SET, EXPAND("data")));
+	Packet frame(pBuffer);
+	vector<thread> threads;
+	for (UInt8 i = 0; i < 4; ++i) {
+		threads.emplace_back([&]() {
+			for (UInt16 j = 0; j < 10000; ++j) {
+				Packet captured(pBuffer);
+				Packet copy(move(frame));
+				CHECK(captured.buffer() == pBuffer && copy.buffer() == pBuffer && memcmp(copy.data(), "data", 4) == 0);
+			}
+		});
+	}
+	for (thread& thread : threads)
+		thread.join();
+	frame = nullptr;
+	CHECK(pBuffer.use_count() == 1); // all the holders released
+}
+
+// Publication fan-out, each subscriber queues a bufferized copy of the frame in its socket (Packet(move(packet)))
+static const UInt32 Subscribers(500);
+static const UInt32 Frames(100);
+
+ADD_TEST(FanOutPerformance) {
+	shared<Buffer> pFrame(SET, 0x10000);
+	Packet frame(pFrame);
+	vector<deque<Packet>> sendings(Subscribers);
+	for (UInt32 i = 0; i < Frames; ++i) {
+		const Packet& packet(frame);
+		for (deque<Packet>& packets : sendings)
+			packets.emplace_back(move(packet));
+	}
+	CHECK(sendings.back().size() == Frames && sendings.back().back().buffer() == frame.buffer());
+}
+
+ADD_TEST(SharedFanOutPerformance) {
+	// before intrusive holder: Packet allocated a new shared<const Binary> by bufferized copy
+	shared<const Binary> pFrame(shared<Buffer>(SET, 0x10000));
+	vector<deque<unique<shared<const Binary>>>> sendings(Subscribers);
+	for (UInt32 i = 0; i < Frames; ++i) {
+		for (deque<unique<shared<const Binary>>>& packets : sendings)
+			packets.emplace_back(new shared<const Binary>(pFrame));
+	}
+	CHECK(sendings.back().size() == Frames && *sendings.back().back() == pFrame);
+}
+
 }
@@ -117,6 +117,83 @@ ADD_TEST(UDP_Blocking) {
 }
 
 
+ADD_TEST(UDP_ReusePort) {
+	Socket server1(Socket::TYPE_DATAGRAM);
+	server1.setReusePort(true);
+	if (!server1.getReusePort())
+		return; // SO_REUSEPORT unsupported
+	SocketAddress address;
+	Exception ex;
+	CHECK(server1.bind(ex, address) && !ex && server1.address());
+
+	Socket server2(Socket::TYPE_DATAGRAM);
+	server2.setReusePort(true);
+	CHECK(server2.bind(ex, server1.address()) && !ex && server2.address() == server1.address());
+
+	// kernel hashes on the peer address, all the datagrams of one client reach the same socket
+	Socket client(Socket::TYPE_DATAGRAM);
+	address.set(IPAddress::Loopback(), server1.address().port());
+	CHECK(client.connect(ex, address) && !ex);
+	for (UInt8 i = 0; i < 10; ++i)
+		CHECK(client.send(ex, EXPAND("hi mathieu and thomas")) == 21 && !ex);
+	Socket& server(server1.available() ? server1 : server2);
+	UInt8 buffer[64];
+	SocketAddress from;
+	for (UInt8 i = 0; i < 10; ++i)
+		CHECK(server.receiveFrom(ex, buffer, sizeof(buffer), from) == 21 && !ex && from == client.address());
+}
+
+ADD_TEST(UDP_Batch) {
+	Socket server(Socket::TYPE_DATAGRAM);
+
+	SocketAddress address;
+	Exception ex;
+	CHECK(server.bind(ex, address) && !ex && server.address());
+
+	Socket client(Socket::TYPE_DATAGRAM);
+	address.set(IPAddress::Loopback(), server.address().port());
+	CHECK(client.connect(ex, address) && !ex);
+	CHECK(client.send(ex, EXPAND("hi mathieu and thomas")) == 21 && !ex);
+	for (UInt8 i = 0; i < 3; ++i)
+		CHECK(UInt32(client.send(ex, _Short0Data.c_str(), _Short0Data.size())) == _Short0Data.size() && !ex);
+	// datagram bigger than batch slot, must not be truncated
+	string big(30000, 'm');
+	CHECK(UInt32(client.send(ex, big.data(), big.size())) == big.size() && !ex);
+
+	shared<Buffer> pBuffers[Socket::RECV_BATCH_MAX];
+	SocketAddress  addresses[Socket::RECV_BATCH_MAX];
+	UInt32 received(0);
+	while (received < 5) {
+		int count = server.receive(ex, pBuffers + received, addresses + received, Socket::RECV_BATCH_MAX - received);
+		CHECK(count > 0 && !ex);
+		received += count;
+	}
+	CHECK(received == 5 && server.recvBatchSize() >= 1);
+	CHECK(pBuffers[0]->size() == 21 && memcmp(pBuffers[0]->data(), EXPAND("hi mathieu and thomas")) == 0 && addresses[0] == client.address());
+	for (UInt8 i = 1; i < 4; ++i)
+		CHECK(pBuffers[i]->size() == _Short0Data.size() && memcmp(pBuffers[i]->data(), _Short0Data.data(), _Short0Data.size()) == 0 && addresses[i] == client.address());
+	CHECK(pBuffers[4]->size() == big.size() && memcmp(pBuffers[4]->data(), big.data(), big.size()) == 0);
+
+	// count by call adapts to the datagrams waiting, from one and doubling while batches are full
+	CHECK(server.setNonBlockingMode(ex, true) && !ex);
+	CHECK(server.receive(ex, pBuffers, addresses, Socket::RECV_BATCH_MAX) < 0 && ex.cast<Ex::Net::Socket>().code == NET_EWOULDBLOCK);
+	ex = nullptr;
+	for (UInt8 i = 0; i < 7; ++i)
+		CHECK(client.send(ex, EXPAND("hi")) == 2 && !ex);
+	for (int count = 1; count <= 4; count <<= 1)
+		CHECK(server.receive(ex, pBuffers, addresses, Socket::RECV_BATCH_MAX) == count && !ex);
+	CHECK(server.setNonBlockingMode(ex, false) && !ex);
+
+	// slot size decays after small datagrams, a big one must still be received entirely (through the spill area)
+	for (UInt8 i = 0; i <= Socket::RECV_SLOT_DECAY; ++i) {
+		CHECK(client.send(ex, EXPAND("hi")) == 2 && !ex);
+		CHECK(server.receive(ex, pBuffers, addresses, Socket::RECV_BATCH_MAX) == 1 && !ex && pBuffers[0]->size() == 2);
+	}
+	CHECK(UInt32(client.send(ex, big.data(), big.size())) == big.size() && !ex);
+	CHECK(server.receive(ex, pBuffers, addresses, Socket::RECV_BATCH_MAX) == 1 && !ex);
+	CHECK(pBuffers[0]->size() == big.size() && memcmp(pBuffers[0]->data(), big.data(), big.size()) == 0);
+}
+
 struct Server : private Thread {
 	Server(const shared<TLS>& pTLS) : _signal(false), _server(Socket::TYPE_STREAM, pTLS), Thread("Server") {}
 	~Server() { stop(); }
@@ -223,6 +300,74 @@ ADD_TEST(TCP_Blocking) {
 	TestTCPBlocking();
 }
 
+ADD_TEST(TCP_SendFile) {
+	Exception ex;
+	const char* name("temp.mona");
+	CHECK(File(name, File::MODE_WRITE).write(ex, _Long0Data.data(), _Long0Data.size()) && !ex);
+
+	// unsupported with TLS
+	shared<TLS> pTLS;
+	CHECK(TLS::Create(ex, pTLS) && !ex);
+	File file(name, File::MODE_READ);
+	CHECK(TLS::Socket(Socket::TYPE_STREAM, pTLS).sendFile(ex, file, 21) < 0 && ex.cast<Ex::Unsupported>());
+	ex = nullptr;
+
+	Server server(nullptr);
+	SocketAddress address(IPAddress::Loopback(), server.bind(SocketAddress()).port());
+	server.accept();
+	Socket client(Socket::TYPE_STREAM);
+	CHECK(client.connect(ex, address) && !ex);
+
+	int sent = client.sendFile(ex, file, 21);
+	if (sent < 0 && ex.cast<Ex::Unsupported>())
+		return; // platform without sendfile
+	CHECK(sent == 21 && !ex && file.readen() == 21);
+	while (file.readen() < file.size())
+		CHECK(client.sendFile(ex, file, UInt32(file.size() - file.readen())) > 0 && !ex);
+	CHECK(client.shutdown(Socket::SHUTDOWN_SEND));
+
+	UInt8 buffer[8192];
+	int received(0);
+	Buffer message;
+	while ((received = client.receive(ex, buffer, sizeof(buffer))) > 0)
+		message.append(buffer, received);
+	CHECK(!ex && message.size() == _Long0Data.size() && memcmp(message.data(), _Long0Data.data(), _Long0Data.size()) == 0);
+
+	// end of file before size (file truncated meanwhile) is an error, not a congestion
+	Socket truncated(Socket::TYPE_STREAM);
+	CHECK(truncated.connect(ex, address) && !ex);
+	CHECK(truncated.sendFile(ex, file, 21) < 0 && ex.cast<Ex::System::File>());
+	ex = nullptr;
+
+	CHECK(File(name, File::MODE_DELETE).erase(ex) && !ex);
+}
+
+ADD_TEST(TCP_Gather) {
+	Exception ex;
+	Server server(nullptr);
+	SocketAddress address(IPAddress::Loopback(), server.bind(SocketAddress()).port());
+	server.accept();
+	Socket client(Socket::TYPE_STREAM);
+	CHECK(client.connect(ex, address) && !ex);
+
+	// header + more payloads than SEND_GATHER_MAX, written without copy
+	shared<Buffer> pPayload(SET, _Short0Data.data(), 512);
+	Packet payload(pPayload);
+	Packets packets(Packet(EXPAND("header")));
+	for (UInt8 i = 0; i < 80; ++i)
+		packets.append(payload);
+	CHECK(packets.count() == 81 && packets.size() == 6 + 80 * 512 && packets[1].buffer() == payload.buffer());
+	CHECK(client.write(ex, packets) == int(packets.size()) && !ex && !client.queueing());
+	CHECK(client.shutdown(Socket::SHUTDOWN_SEND));
+
+	UInt8 buffer[8192];
+	int received(0);
+	Buffer message;
+	while ((received = client.receive(ex, buffer, sizeof(buffer))) > 0)
+		message.append(buffer, received);
+	CHECK(!ex && message.size() == packets.size() && memcmp(message.data(), EXPAND("header")) == 0 && memcmp(message.data() + 6, _Short0Data.data(), 512) == 0);
+}
+
 ADD_TEST(TCP_SSL_Blocking) {
 	Exception ex;
 	shared<TLS> pClientTLS, pServerTLS;
@@ -301,6 +446,51 @@ ADD_TEST(UDP_NonBlocking) {
 	CHECK(!io.subscribers());
 }
 
+ADD_TEST(UDP_SendBatch) {
+	MainHandler	handler;
+	IOSocket	io(handler, _ThreadPool);
+	Exception ex;
+
+	// two receivers to check different destination addresses in the same batch
+	Socket receiver1(Socket::TYPE_DATAGRAM), receiver2(Socket::TYPE_DATAGRAM);
+	Socket* receivers[2] = { &receiver1, &receiver2 };
+	SocketAddress addresses[2];
+	for (UInt8 i = 0; i < 2; ++i) {
+		CHECK(receivers[i]->bind(ex, IPAddress::Loopback()) && !ex);
+		addresses[i].set(IPAddress::Loopback(), receivers[i]->address().port());
+	}
+
+	UDPSocket sender(io);
+	sender.onError = [](const Exception& ex) { FATAL_ERROR("UDPSender, ", ex); };
+	sender->setSendBatch(true);
+	CHECK(sender.bind(ex, IPAddress::Loopback()) && !ex && sender->getSendBatch());
+	for (UInt8 i = 0; i < 20; ++i) {
+		Packet packet(_Short0Data.data(), i + 1);
+		CHECK(sender.send(ex, packet, addresses[i % 2]) && !ex);
+	}
+
+	UInt8 buffer[2048];
+	SocketAddress from;
+	for (UInt8 i = 0; i < 20; ++i)
+		CHECK(receivers[i % 2]->receiveFrom(ex, buffer, sizeof(buffer), from) == (i + 1) && !ex && from == sender->address());
+
+	// burst of equal-sized datagrams to the same destination (GSO when available), the last smaller
+	for (UInt8 i = 0; i < 11; ++i) {
+		Packet packet(_Short0Data.data(), i < 10 ? 1000 : 500);
+		CHECK(sender.send(ex, packet, addresses[0]) && !ex);
+	}
+	for (UInt8 i = 0; i < 11; ++i)
+		CHECK(receiver1.receiveFrom(ex, buffer, sizeof(buffer), from) == (i < 10 ? 1000 : 500) && !ex && from == sender->address());
+	_ThreadPool.join();
+	CHECK(!sender->queueing() && sender->sendBatchSize() >= 1);
+
+	sender.onError = nullptr;
+	sender.close();
+	_ThreadPool.join();
+	handler.flush(true);
+	CHECK(!io.subscribers());
+}
+
 struct TCPEchoClient : TCPClient {
 	TCPEchoClient(IOSocket& io, const shared<TLS>& pTLS = nullptr) : TCPClient(io, pTLS) {
 
@@ -377,10 +567,16 @@ private:
 	set<TCPClient*> _connections;
 };
 
-void TestTCPNonBlocking(const shared<TLS>& pClientTLS = nullptr, const shared<TLS>& pServerTLS = nullptr) {
+void TestTCPNonBlocking(const shared<TLS>& pClientTLS = nullptr, const shared<TLS>& pServerTLS = nullptr, UInt16 shards = 0, UInt32 zeroCopy = 0, IOSocket::Backend backend = IOSocket::BACKEND_SYSTEM) {
 	Exception ex;
 	MainHandler	 handler;
 	IOSocket io(handler, _ThreadPool);
+	CHECK(io.setShards(ex, shards) && !ex && io.shards() == (shards > 1 ? shards : 0));
+	if (!io.setBackend(ex, backend)) {
+		CHECK(ex.cast<Ex::Unsupported>()); // backend not supported by the system
+		return;
+	}
+	CHECK(!ex && io.backend() == backend);
 
 	TCPEchoServer   server(io, pServerTLS, pClientTLS);
 
@@ -393,9 +589,21 @@ void TestTCPNonBlocking(const shared<TLS>& pClientTLS = nullptr, const shared<TL
 	TCPEchoClient client(io, pClientTLS);
 	SocketAddress target(IPAddress::Loopback(), address.port());
 	CHECK(client.connect(ex, target) && !ex && client->peerAddress() == target);
+	if (shards > 1) { // sockets subscribed, too late to shard
+		CHECK(!io.setShards(ex, shards) && ex.cast<Ex::Intern>() && io.shards() == shards);
+		ex = nullptr;
+	}
+	if (backend) { // sockets subscribed, too late to change backend
+		CHECK(!io.setBackend(ex, IOSocket::BACKEND_SYSTEM) && ex.cast<Ex::Intern>() && io.backend() == backend);
+		ex = nullptr;
+	}
+	if (zeroCopy)
+		CHECK(client->setZeroCopy(ex, zeroCopy) && !ex && client->getZeroCopy() == zeroCopy);
 	client.echo(EXPAND("hi mathieu and thomas"));
 	client.echo(_Long0Data.c_str(), _Long0Data.size());
 	CHECK(handler.join([&]()->bool { return client.connected() && !client.echoing(); } ));
+	// packets sent in zero-copy are released on completion
+	CHECK(handler.join([&]()->bool { return !client->zeroCopying(); }));
 
 	CHECK(server.count() == 1 && (*server.begin())->connected() && (**server.begin())->peerAddress() == client->address() && client->peerAddress() == (**server.begin())->address())
 
@@ -436,6 +644,48 @@ ADD_TEST(TCP_SSL_NonBlocking) {
 	TestTCPNonBlocking(pClientTLS, pServerTLS);
 }
 
+ADD_TEST(TCP_SSL_Kernel) {
+	// kTLS when the system supports it, else fallback on OpenSSL encryption
+	Exception ex;
+	shared<TLS> pClientTLS, pServerTLS;
+	CHECK(TLS::Create(ex, pClientTLS) && !ex);
+	CHECK(TLS::Create(ex, "cert.pem", "key.pem", pServerTLS) && !ex);
+	if (!pClientTLS->setKernel(ex, true) || !pServerTLS->setKernel(ex, true)) {
+		CHECK(ex.cast<Ex::Unsupported>() && !pClientTLS->getKernel());
+		return;
+	}
+	CHECK(pClientTLS->getKernel() && pServerTLS->getKernel());
+	TestTCPBlocking(pClientTLS, pServerTLS);
+	TestTCPNonBlocking(pClientTLS, pServerTLS);
+	CHECK(pClientTLS->setKernel(ex, false) && !pClientTLS->getKernel());
+}
+
+#if !defined(_WIN32) && !defined(_BSD)
+ADD_TEST(TCP_Sharded) {
+	TestTCPNonBlocking(nullptr, nullptr, 4);
+}
+
+ADD_TEST(TCP_ZeroCopy) {
+	TestTCPNonBlocking(nullptr, nullptr, 0, 1024);
+	TestTCPNonBlocking(nullptr, nullptr, 2, 1024);
+	// unsupported with TLS
+	Exception ex;
+	shared<TLS> pTLS;
+	CHECK(TLS::Create(ex, pTLS) && !ex);
+	CHECK(!TLS::Socket(Socket::TYPE_STREAM, pTLS).setZeroCopy(ex, 1024) && ex.cast<Ex::Unsupported>());
+}
+
+ADD_TEST(TCP_URing) {
+	TestTCPNonBlocking(nullptr, nullptr, 0, 0, IOSocket::BACKEND_URING);
+	TestTCPNonBlocking(nullptr, nullptr, 2, 1024, IOSocket::BACKEND_URING);
+	Exception ex;
+	shared<TLS> pClientTLS, pServerTLS;
+	CHECK(TLS::Create(ex, pClientTLS) && !ex);
+	CHECK(TLS::Create(ex, "cert.pem", "key.pem", pServerTLS) && !ex);
+	TestTCPNonBlocking(pClientTLS, pServerTLS, 2, 0, IOSocket::BACKEND_URING);
+}
+#endif
+
 
 ADD_TEST(TestTCPLoad) {
 	Exception ex;
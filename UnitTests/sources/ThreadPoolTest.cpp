@@ -0,0 +1,135 @@
+/*
+This file is a part of MonaSolutions Copyright 2017
+mathieu.poux[a]gmail.com
+jammetthomas[a]gmail.com
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License received along this program for more
+details (or else see http://www.gnu.org/licenses/).
+
+*/
+
+#include "Mona/UnitTest.h"
+#include "Mona/ThreadPool.h"
+#include "Mona/Handler.h"
+
+using namespace Mona;
+using namespace std;
+
+namespace ThreadPoolTest {
+
+struct Task : Runner {
+	Task(std::function<void()>&& function) : Runner("Task"), _function(move(function)) {}
+private:
+	bool run(Exception& ex) { _function(); return true; }
+	std::function<void()> _function;
+};
+
+ADD_TEST(Affinity) {
+	ThreadPool threadPool(4);
+	UInt16 thread(0);
+	ThreadQueue* pThread(NULL);
+	UInt32 count(0);
+	for (UInt32 i = 0; i < 1000; ++i) {
+		threadPool.queue<Task>(thread, [&, i]() {
+			if (!pThread)
+				pThread = ThreadQueue::Current();
+			CHECK(ThreadQueue::Current() == pThread && count++ == i); // same thread and order preserved
+		});
+		CHECK(thread);
+	}
+	threadPool.join();
+	CHECK(count == 1000 && !threadPool.thread(thread).queueing() && !threadPool.thread(thread).steals());
+}
+
+ADD_TEST(Stealing) {
+	ThreadPool threadPool(2);
+	// make busy the thread 1 (_current++ % 2 of the next queue will be thread 1)
+	Signal busy, release;
+	UInt16 thread(0);
+	threadPool.queue<Task>(thread, [&]() { busy.set(); release.wait(); });
+	busy.wait();
+	// runners without affinity queued on thread 1 have to be stolen by thread 2
+	atomic<UInt32> count(0);
+	Signal done;
+	for (UInt32 i = 0; i < 100; ++i) {
+		threadPool.queue<Task>(nullptr, [&]() {
+			if (++count == 100)
+				done.set();
+		});
+	}
+	CHECK(done.wait(5000) && count == 100);
+	CHECK(threadPool.thread(thread).queueing() == 0 && threadPool.thread(thread == 1 ? 2 : 1).steals() >= 50);
+	release.set();
+	threadPool.join();
+}
+
+ADD_TEST(MPSCQueue) {
+	MPSCQueue<UInt32> queue;
+	vector<thread> producers;
+	for (UInt32 i = 0; i < 4; ++i) {
+		producers.emplace_back([&queue, i]() {
+			for (UInt32 value = 0; value < 10000; ++value)
+				queue.push((i << 16) | value);
+		});
+	}
+	// consume during the production, order by producer has to be preserved
+	UInt32 nexts[4] = { 0, 0, 0, 0 };
+	UInt32 count(0);
+	while (count < 40000) {
+		deque<UInt32> values;
+		queue.pop(values);
+		for (UInt32 value : values) {
+			CHECK((value & 0xFFFF) == nexts[value >> 16]++);
+			++count;
+		}
+	}
+	for (thread& producer : producers)
+		producer.join();
+	UInt32 value;
+	CHECK(!queue.pop(value) && queue.count() == 0 && queue.wakeUps() >= 1);
+}
+
+ADD_TEST(Handler) {
+	Signal signal;
+	Handler handler(signal);
+	UInt32 count(0);
+	// queueings on a non-empty queue are coalesced in one wake-up
+	for (UInt32 i = 0; i < 100; ++i)
+		handler.queue<Task>([&count]() { ++count; });
+	CHECK(signal.wait(1) && handler.wakeUps() == 1);
+	CHECK(handler.flush() == 100 && count == 100 && !signal.wait(1));
+	handler.queue<Task>([&count]() { ++count; });
+	CHECK(signal.wait(1) && handler.wakeUps() == 2 && handler.flush() == 1 && count == 101);
+	// last flush, no more queueing
+	CHECK(handler.flush(true) == 0 && !handler.tryQueue<Task>([&count]() { ++count; }));
+}
+
+ADD_TEST(HandlerClose) {
+	Signal signal;
+	Handler handler(signal);
+	atomic<UInt32> ran(0), accepted(0);
+	vector<thread> producers;
+	for (UInt32 i = 0; i < 4; ++i) {
+		producers.emplace_back([&]() {
+			// queue until the last flush, every runner accepted has to run
+			while (handler.tryQueue<Task>([&ran]() { ++ran; }))
+				++accepted;
+		});
+	}
+	for (UInt32 i = 0; i < 10; ++i)
+		handler.flush();
+	handler.flush(true);
+	for (thread& producer : producers)
+		producer.join();
+	CHECK(ran == accepted);
+}
+
+}
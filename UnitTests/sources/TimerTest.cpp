@@ -20,6 +20,8 @@ details (or else see http://www.gnu.org/licenses/).
 #include "Mona/Stopwatch.h"
 #include "Mona/Timer.h"
 #include "Mona/Thread.h"
+#include <set>
+#include <map>
 
 using namespace Mona;
 using namespace std;
@@ -71,4 +73,55 @@ ADD_TEST(All) {
 	CHECK(!timer.count() && !timer.raise())
 }
 
+// Re-arm pattern of session keepalive/timeout timers, time of Performance tests to compare
+static const UInt32 Timers(10000);
+static const UInt32 Rearms(10);
+static UInt32 Timeout(UInt32 i) { return 1000 + (i * 7919) % 60000; }
+
+ADD_TEST(WheelPerformance) {
+	Timer timer;
+	unique<Timer::OnTimer[]> onTimers(new Timer::OnTimer[Timers]());
+	for (UInt32 rearm = 0; rearm < Rearms; ++rearm) {
+		for (UInt32 i = 0; i < Timers; ++i)
+			timer.set(onTimers[i], Timeout(i + rearm));
+	}
+	CHECK(timer.count() == Timers && timer.raise());
+	for (UInt32 i = 0; i < Timers; ++i)
+		timer.set(onTimers[i], 0);
+	CHECK(!timer.count() && !timer.raise());
+}
+
+ADD_TEST(MapPerformance) {
+	// Timer implementation before the timing wheel, std::map by raising time
+	struct MapTimer : virtual Object {
+		void set(Int64& nextRaising, UInt32 timeout) {
+			if (nextRaising) {
+				const auto& it = _timers.find(nextRaising);
+				it->second->erase(&nextRaising);
+				if (it->second->empty())
+					_timers.erase(it);
+				nextRaising = 0;
+			}
+			if (!timeout)
+				return;
+			shared<std::set<Int64*>>& pTimers(_timers[nextRaising = Time::Now() + timeout]);
+			if (!pTimers)
+				pTimers.set();
+			pTimers->emplace(&nextRaising);
+		}
+		UInt32 raise() { return _timers.empty() ? 0 : UInt32(max<Int64>(_timers.begin()->first - Time::Now(), 1)); }
+	private:
+		std::map<Int64, shared<std::set<Int64*>>> _timers;
+	} timer;
+	unique<Int64[]> nextRaisings(new Int64[Timers]());
+	for (UInt32 rearm = 0; rearm < Rearms; ++rearm) {
+		for (UInt32 i = 0; i < Timers; ++i)
+			timer.set(nextRaisings[i], Timeout(i + rearm));
+	}
+	CHECK(timer.raise());
+	for (UInt32 i = 0; i < Timers; ++i)
+		timer.set(nextRaisings[i], 0);
+	CHECK(!timer.raise());
+}
+
 }